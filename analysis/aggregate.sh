@@ -24,6 +24,11 @@ find "${RESULT_ROOT}" -name flowmon.xml | while read -r xml; do
   run=$(basename "${run_dir}" | sed 's/run-//')
   tcp=$(basename "${tcp_dir}")
   scenario=$(basename "${scenario_dir}")
+  # Swept runs live in results/loss-<x>/ or results/blockage-<x>/; keep the value in the label
+  sweep_dir=$(dirname "${scenario_dir}")
+  if [[ "${sweep_dir%/}" != "${RESULT_ROOT%/}" ]]; then
+    scenario="${scenario}/$(basename "${sweep_dir}")"
+  fi
 
   awk -v warmup="${WARMUP}" -v scenario="${scenario}" -v tcp="${tcp}" -v run="${run}" '
     BEGIN { FS="[=\" ]+"; OFS=","; }
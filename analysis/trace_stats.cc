@@ -0,0 +1,644 @@
+// Congestion-window trace analytics for a results/ tree (see trace_stats.sh).
+//
+// Every results/[<sweep>/]<scenario>/<tcp>/run-<n>/cwnd.csv is memory-mapped and reduced in one
+// streaming pass by a pool of worker threads; each worker needs a fixed ~260 KB of
+// scratch space regardless of trace size. Per run, over the steady-state window
+// [warmup, last sample]:
+//   - time-weighted mean cwnd and time-weighted p5/p50/p95 (bytes, from a histogram)
+//   - multiplicative-decrease events and the mean sawtooth period between them
+// Per {scenario, tcp}, the run-level metrics are combined across seeds with a
+// percentile bootstrap confidence interval.
+//
+// Outputs (tidy CSV):
+//   cwnd_runs.csv     one row per run
+//   cwnd_summary.csv  one row per {scenario, tcp, metric}
+//
+// Build: c++ -O3 -std=c++17 -fopenmp-simd -pthread -o trace_stats trace_stats.cc
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+struct Options
+{
+  std::string resultRoot;
+  std::string outputRoot = "out";
+  double warmup = 20.0;
+  double decreaseRatio = 0.95; // newCwnd below this fraction of oldCwnd counts as a back-off
+  unsigned threads = 0;
+  unsigned bootstrap = 2000;
+  double confidence = 0.95;
+  uint64_t seed = 1;
+};
+
+struct RunKey
+{
+  std::string scenario;
+  std::string tcp;
+  std::string run;
+};
+
+struct RunStats
+{
+  bool valid = false;
+  uint64_t samples = 0;
+  double windowStart = 0.0;
+  double windowEnd = 0.0;
+  double meanCwnd = 0.0;
+  double p5 = 0.0;
+  double p50 = 0.0;
+  double p95 = 0.0;
+  double minCwnd = 0.0;
+  double maxCwnd = 0.0;
+  uint64_t decreases = 0;
+  double sawtoothPeriod = std::nan ("");
+};
+
+// Time-weighted cwnd histogram with 2^kSubBits linear sub-buckets per power of two
+// (HDR-style), so its size does not depend on the trace length. Each bucket also keeps
+// the weighted sum of its values and reports their weighted mean, which is exact when a
+// bucket holds one distinct cwnd and otherwise within 2^-kSubBits (0.4%) of it.
+class CwndHistogram
+{
+public:
+  void Reset ()
+  {
+    std::fill (m_weight.begin (), m_weight.end (), 0.0);
+    std::fill (m_valueWeight.begin (), m_valueWeight.end (), 0.0);
+  }
+
+  void Add (double value, double weight)
+  {
+    int exponent;
+    const double mantissa = std::frexp (value, &exponent); // value = mantissa * 2^exponent, mantissa in [0.5, 1)
+    size_t bucket = 0;
+    if (value >= 1.0)
+      {
+        const size_t octave = std::min<size_t> (exponent - 1, kOctaves - 1);
+        const size_t sub = static_cast<size_t> ((2.0 * mantissa - 1.0) * kSubBuckets);
+        bucket = octave * kSubBuckets + std::min<size_t> (sub, kSubBuckets - 1);
+      }
+    m_weight[bucket] += weight;
+    m_valueWeight[bucket] += value * weight;
+  }
+
+  // The value below which the window spent fraction q of its time.
+  double Percentile (double q, double totalWeight) const
+  {
+    const double target = q * totalWeight;
+    double seen = 0.0;
+    size_t last = 0;
+    for (size_t b = 0; b < kBuckets; ++b)
+      {
+        if (m_weight[b] <= 0.0)
+          {
+            continue;
+          }
+        last = b;
+        seen += m_weight[b];
+        if (seen >= target)
+          {
+            return m_valueWeight[b] / m_weight[b];
+          }
+      }
+    return m_weight[last] > 0.0 ? m_valueWeight[last] / m_weight[last] : 0.0;
+  }
+
+private:
+  static const size_t kSubBits = 8;
+  static const size_t kSubBuckets = size_t{1} << kSubBits;
+  static const size_t kOctaves = 40; // 1 B to 1 TB
+  static const size_t kBuckets = kOctaves * kSubBuckets;
+
+  std::array<double, kBuckets> m_weight{};
+  std::array<double, kBuckets> m_valueWeight{};
+};
+
+// Per-worker scratch space, reused for every file the worker processes: the histogram
+// and one block of parsed rows. Row 0 of a block carries the last sample of the previous
+// block, so segment k runs from time[k] to time[k + 1] without crossing block borders.
+struct TraceScratch
+{
+  static const size_t kBlockRows = 4096;
+
+  CwndHistogram histogram;
+  double time[kBlockRows + 1];
+  double cwnd[kBlockRows + 1];
+  double weight[kBlockRows];
+};
+
+[[noreturn]] void
+Fail (const std::string &message)
+{
+  std::cerr << "[ERROR] trace_stats: " << message << std::endl;
+  std::exit (1);
+}
+
+// Exact powers of ten representable as doubles.
+const double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+const int kMaxPow10 = 22;
+
+// Minimal decimal parser (digits, '.', exponent); avoids locale-aware strtod.
+const char *
+ParseNumber (const char *p, const char *end, double &value)
+{
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+    {
+      negative = *p == '-';
+      ++p;
+    }
+  double mantissa = 0.0;
+  int exponent = 0;
+  bool digits = false;
+  while (p < end && *p >= '0' && *p <= '9')
+    {
+      mantissa = mantissa * 10.0 + (*p++ - '0');
+      digits = true;
+    }
+  if (p < end && *p == '.')
+    {
+      ++p;
+      while (p < end && *p >= '0' && *p <= '9')
+        {
+          mantissa = mantissa * 10.0 + (*p++ - '0');
+          --exponent;
+          digits = true;
+        }
+    }
+  if (!digits)
+    {
+      return nullptr;
+    }
+  if (p < end && (*p == 'e' || *p == 'E'))
+    {
+      ++p;
+      bool negativeExp = false;
+      if (p < end && (*p == '-' || *p == '+'))
+        {
+          negativeExp = *p == '-';
+          ++p;
+        }
+      int e = 0;
+      while (p < end && *p >= '0' && *p <= '9')
+        {
+          e = e * 10 + (*p++ - '0');
+        }
+      exponent += negativeExp ? -e : e;
+    }
+  if (exponent >= 0 && exponent <= kMaxPow10)
+    {
+      mantissa *= kPow10[exponent];
+    }
+  else if (exponent < 0 && exponent >= -kMaxPow10)
+    {
+      mantissa /= kPow10[-exponent];
+    }
+  else
+    {
+      mantissa *= std::pow (10.0, exponent);
+    }
+  value = negative ? -mantissa : mantissa;
+  return p;
+}
+
+// Running state of one steady-state window [warmup, last sample], fed block by block.
+struct WindowState
+{
+  uint64_t rows = 0;
+  uint64_t samples = 0;
+  double firstTime = 0.0;
+  double lastTime = 0.0;
+  double weightedSum = 0.0;
+  double totalWeight = 0.0;
+  double minCwnd = std::numeric_limits<double>::infinity ();
+  double maxCwnd = -std::numeric_limits<double>::infinity ();
+  uint64_t decreases = 0;
+  double firstDecrease = 0.0;
+  double lastDecrease = 0.0;
+};
+
+// Folds the segments between rows 0..count-1 of the scratch block into the window.
+// Segment k holds cwnd[k] from time[k] to time[k + 1]; the segment that straddles the
+// warm-up boundary is clipped to start there, and earlier segments are ignored.
+void
+FoldBlock (TraceScratch &scratch, size_t count, double warmup, WindowState &state)
+{
+  const double *time = scratch.time;
+  const double *cwnd = scratch.cwnd;
+  double *w = scratch.weight;
+  const size_t segments = count - 1;
+  const double inf = std::numeric_limits<double>::infinity ();
+
+  double weightedSum = 0.0;
+  double totalWeight = 0.0;
+  double minCwnd = state.minCwnd;
+  double maxCwnd = state.maxCwnd;
+#pragma omp simd reduction(+ : weightedSum, totalWeight) reduction(min : minCwnd) reduction(max : maxCwnd)
+  for (size_t k = 0; k < segments; ++k)
+    {
+      const bool inWindow = time[k + 1] >= warmup;
+      w[k] = inWindow ? time[k + 1] - std::max (time[k], warmup) : 0.0;
+      weightedSum += cwnd[k] * w[k];
+      totalWeight += w[k];
+      minCwnd = std::min (minCwnd, inWindow ? cwnd[k] : inf);
+      maxCwnd = std::max (maxCwnd, inWindow ? cwnd[k] : -inf);
+    }
+  state.weightedSum += weightedSum;
+  state.totalWeight += totalWeight;
+  state.minCwnd = minCwnd;
+  state.maxCwnd = maxCwnd;
+
+  for (size_t k = 0; k < segments; ++k)
+    {
+      if (w[k] > 0.0)
+        {
+          scratch.histogram.Add (cwnd[k], w[k]);
+        }
+    }
+}
+
+// Parses "time,oldCwnd,newCwnd" rows in one streaming pass (header and malformed lines
+// are skipped) and reduces them to run statistics. Memory use is bounded by the scratch
+// space, whatever the trace length; already parsed pages of the page-aligned mapping
+// are dropped from the resident set as the pass advances.
+RunStats
+AnalyseTrace (const char *data, size_t size, const Options &opts, TraceScratch &scratch)
+{
+  const size_t kReleaseBytes = size_t{32} << 20;
+  const double warmup = opts.warmup;
+  WindowState state;
+  scratch.histogram.Reset ();
+  size_t count = 0;
+
+  const char *p = data;
+  const char *end = data + size;
+  size_t released = 0;
+  while (p < end)
+    {
+      if (static_cast<size_t> (p - data) >= released + kReleaseBytes)
+        {
+          madvise (const_cast<char *> (data) + released, kReleaseBytes, MADV_DONTNEED);
+          released += kReleaseBytes;
+        }
+      const char *eol = static_cast<const char *> (std::memchr (p, '\n', end - p));
+      if (!eol)
+        {
+          eol = end;
+        }
+      double t, oldCwnd, newCwnd;
+      const char *q = ParseNumber (p, eol, t);
+      p = eol + 1;
+      if (!(q && q < eol && *q == ',' && (q = ParseNumber (q + 1, eol, oldCwnd)) && q < eol && *q == ','
+            && (q = ParseNumber (q + 1, eol, newCwnd))))
+        {
+          continue;
+        }
+
+      if (state.rows++ == 0)
+        {
+          state.firstTime = t;
+        }
+      state.lastTime = t;
+      // Multiplicative decreases inside the window mark the sawtooth teeth.
+      if (t >= warmup)
+        {
+          ++state.samples;
+          if (newCwnd < oldCwnd * opts.decreaseRatio)
+            {
+              if (state.decreases == 0)
+                {
+                  state.firstDecrease = t;
+                }
+              state.lastDecrease = t;
+              ++state.decreases;
+            }
+        }
+
+      scratch.time[count] = t;
+      scratch.cwnd[count] = newCwnd;
+      if (++count == TraceScratch::kBlockRows + 1)
+        {
+          FoldBlock (scratch, count, warmup, state);
+          scratch.time[0] = scratch.time[count - 1];
+          scratch.cwnd[0] = scratch.cwnd[count - 1];
+          count = 1;
+        }
+    }
+  if (count > 1)
+    {
+      FoldBlock (scratch, count, warmup, state);
+    }
+
+  RunStats stats;
+  if (state.samples == 0 || state.lastTime <= warmup || state.totalWeight <= 0.0)
+    {
+      return stats;
+    }
+  stats.valid = true;
+  stats.samples = state.samples;
+  stats.windowStart = state.firstTime >= warmup ? state.firstTime : warmup;
+  stats.windowEnd = state.lastTime;
+  stats.meanCwnd = state.weightedSum / state.totalWeight;
+  stats.p5 = scratch.histogram.Percentile (0.05, state.totalWeight);
+  stats.p50 = scratch.histogram.Percentile (0.50, state.totalWeight);
+  stats.p95 = scratch.histogram.Percentile (0.95, state.totalWeight);
+  stats.minCwnd = state.minCwnd;
+  stats.maxCwnd = state.maxCwnd;
+  stats.decreases = state.decreases;
+  if (state.decreases > 1)
+    {
+      stats.sawtoothPeriod = (state.lastDecrease - state.firstDecrease) / (state.decreases - 1);
+    }
+  return stats;
+}
+
+bool
+MapAndAnalyse (const std::string &path, const Options &opts, TraceScratch &scratch, RunStats &stats)
+{
+  const int fd = open (path.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || st.st_size == 0)
+    {
+      close (fd);
+      return false;
+    }
+  const size_t size = static_cast<size_t> (st.st_size);
+  void *data = mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      return false;
+    }
+  madvise (data, size, MADV_SEQUENTIAL);
+  stats = AnalyseTrace (static_cast<const char *> (data), size, opts, scratch);
+  munmap (data, size);
+  return true;
+}
+
+// Percentile bootstrap CI for the mean of the per-run values.
+void
+BootstrapMean (const std::vector<double> &values, const Options &opts, std::mt19937_64 &rng, double &mean,
+               double &low, double &high)
+{
+  const size_t n = values.size ();
+  mean = 0.0;
+  for (double v : values)
+    {
+      mean += v;
+    }
+  mean /= n;
+  if (n < 2)
+    {
+      low = high = mean;
+      return;
+    }
+  std::uniform_int_distribution<size_t> pick (0, n - 1);
+  std::vector<double> means (opts.bootstrap);
+  for (unsigned b = 0; b < opts.bootstrap; ++b)
+    {
+      double sum = 0.0;
+      for (size_t i = 0; i < n; ++i)
+        {
+          sum += values[pick (rng)];
+        }
+      means[b] = sum / n;
+    }
+  std::sort (means.begin (), means.end ());
+  const double alpha = (1.0 - opts.confidence) / 2.0;
+  low = means[static_cast<size_t> (alpha * (opts.bootstrap - 1))];
+  high = means[static_cast<size_t> ((1.0 - alpha) * (opts.bootstrap - 1))];
+}
+
+Options
+ParseArgs (int argc, char *argv[])
+{
+  Options opts;
+  for (int i = 1; i < argc; ++i)
+    {
+      const std::string flag = argv[i];
+      if (i + 1 >= argc)
+        {
+          Fail ("missing value for " + flag);
+        }
+      const char *value = argv[++i];
+      if (flag == "--root")
+        {
+          opts.resultRoot = value;
+        }
+      else if (flag == "--out")
+        {
+          opts.outputRoot = value;
+        }
+      else if (flag == "--warmup")
+        {
+          opts.warmup = std::atof (value);
+        }
+      else if (flag == "--threads")
+        {
+          opts.threads = static_cast<unsigned> (std::atoi (value));
+        }
+      else if (flag == "--bootstrap")
+        {
+          opts.bootstrap = std::max (1, std::atoi (value));
+        }
+      else if (flag == "--confidence")
+        {
+          opts.confidence = std::atof (value);
+        }
+      else if (flag == "--decrease-ratio")
+        {
+          opts.decreaseRatio = std::atof (value);
+        }
+      else if (flag == "--seed")
+        {
+          opts.seed = std::strtoull (value, nullptr, 10);
+        }
+      else
+        {
+          Fail ("unknown option " + flag);
+        }
+    }
+  if (opts.resultRoot.empty ())
+    {
+      Fail ("usage: trace_stats --root <results> [--out dir] [--warmup s] [--threads n] [--bootstrap b]");
+    }
+  if (opts.threads == 0)
+    {
+      opts.threads = std::max (1u, std::thread::hardware_concurrency ());
+    }
+  return opts;
+}
+
+} // namespace
+
+int
+main (int argc, char *argv[])
+{
+  const Options opts = ParseArgs (argc, argv);
+  namespace fs = std::filesystem;
+
+  if (!fs::is_directory (opts.resultRoot))
+    {
+      Fail ("result directory not found: " + opts.resultRoot);
+    }
+
+  // results/[loss-<x>/|blockage-<x>/]<scenario>/<tcp>/run-<n>/cwnd.csv
+  std::vector<std::string> paths;
+  std::vector<RunKey> keys;
+  for (const auto &entry : fs::recursive_directory_iterator (opts.resultRoot))
+    {
+      if (!entry.is_regular_file () || entry.path ().filename () != "cwnd.csv")
+        {
+          continue;
+        }
+      const fs::path runDir = entry.path ().parent_path ();
+      const fs::path tcpDir = runDir.parent_path ();
+      std::string run = runDir.filename ().string ();
+      if (run.rfind ("run-", 0) == 0)
+        {
+          run = run.substr (4);
+        }
+      // Swept runs live in results/loss-<x>/ or results/blockage-<x>/; keep the value in the label
+      const fs::path scenarioDir = tcpDir.parent_path ();
+      std::string scenario = scenarioDir.filename ().string ();
+      if (!fs::equivalent (scenarioDir.parent_path (), opts.resultRoot))
+        {
+          scenario += "/" + scenarioDir.parent_path ().filename ().string ();
+        }
+      paths.push_back (entry.path ().string ());
+      keys.push_back ({scenario, tcpDir.filename ().string (), run});
+    }
+  if (paths.empty ())
+    {
+      Fail ("no cwnd.csv files under " + opts.resultRoot);
+    }
+
+  // Stable, human-friendly row order regardless of directory iteration order
+  std::vector<size_t> order (paths.size ());
+  for (size_t i = 0; i < order.size (); ++i)
+    {
+      order[i] = i;
+    }
+  std::sort (order.begin (), order.end (), [&keys] (size_t a, size_t b) {
+    const RunKey &x = keys[a];
+    const RunKey &y = keys[b];
+    if (x.scenario != y.scenario)
+      {
+        return x.scenario < y.scenario;
+      }
+    if (x.tcp != y.tcp)
+      {
+        return x.tcp < y.tcp;
+      }
+    return std::atoll (x.run.c_str ()) < std::atoll (y.run.c_str ());
+  });
+
+  std::vector<RunStats> results (paths.size ());
+  std::atomic<size_t> next (0);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < std::min<size_t> (opts.threads, paths.size ()); ++t)
+    {
+      workers.emplace_back ([&] () {
+        std::unique_ptr<TraceScratch> scratch (new TraceScratch);
+        for (size_t i = next++; i < paths.size (); i = next++)
+          {
+            MapAndAnalyse (paths[i], opts, *scratch, results[i]);
+          }
+      });
+    }
+  for (auto &worker : workers)
+    {
+      worker.join ();
+    }
+
+  fs::create_directories (opts.outputRoot);
+  std::ofstream runsCsv (opts.outputRoot + "/cwnd_runs.csv");
+  runsCsv << "scenario,tcp,run,samples,window_start_s,window_end_s,mean_cwnd_bytes,p5_cwnd_bytes,"
+             "p50_cwnd_bytes,p95_cwnd_bytes,min_cwnd_bytes,max_cwnd_bytes,decreases,sawtooth_period_s"
+          << std::endl;
+
+  // Per-run metrics grouped by {scenario, tcp} for the bootstrap
+  const char *const metricNames[] = {"mean_cwnd_bytes", "p50_cwnd_bytes", "p95_cwnd_bytes", "sawtooth_period_s"};
+  std::map<std::pair<std::string, std::string>, std::vector<std::vector<double>>> groups;
+  size_t skipped = 0;
+  for (size_t i : order)
+    {
+      const RunStats &s = results[i];
+      if (!s.valid)
+        {
+          ++skipped;
+          continue;
+        }
+      runsCsv << keys[i].scenario << "," << keys[i].tcp << "," << keys[i].run << "," << s.samples << ","
+              << s.windowStart << "," << s.windowEnd << "," << s.meanCwnd << "," << s.p5 << "," << s.p50 << ","
+              << s.p95 << "," << s.minCwnd << "," << s.maxCwnd << "," << s.decreases << ",";
+      if (!std::isnan (s.sawtoothPeriod))
+        {
+          runsCsv << s.sawtoothPeriod;
+        }
+      runsCsv << std::endl;
+
+      auto &metrics = groups[{keys[i].scenario, keys[i].tcp}];
+      metrics.resize (4);
+      const double values[] = {s.meanCwnd, s.p50, s.p95, s.sawtoothPeriod};
+      for (size_t m = 0; m < 4; ++m)
+        {
+          if (!std::isnan (values[m]))
+            {
+              metrics[m].push_back (values[m]);
+            }
+        }
+    }
+
+  std::ofstream summaryCsv (opts.outputRoot + "/cwnd_summary.csv");
+  summaryCsv << "scenario,tcp,metric,runs,mean,ci_low,ci_high" << std::endl;
+  std::mt19937_64 rng (opts.seed);
+  for (const auto &group : groups)
+    {
+      for (size_t m = 0; m < 4; ++m)
+        {
+          const std::vector<double> &values = group.second[m];
+          if (values.empty ())
+            {
+              continue;
+            }
+          double mean, low, high;
+          BootstrapMean (values, opts, rng, mean, low, high);
+          summaryCsv << group.first.first << "," << group.first.second << "," << metricNames[m] << ","
+                     << values.size () << "," << mean << "," << low << "," << high << std::endl;
+        }
+    }
+
+  std::cerr << "[INFO] Analysed " << paths.size () - skipped << " of " << paths.size () << " cwnd traces ("
+            << skipped << " empty or shorter than warm-up); tables in " << opts.outputRoot << std::endl;
+  return 0;
+}
@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+RESULT_ROOT=${RESULT_ROOT:-$HOME/ns-3/results}
+OUTPUT_ROOT=${OUTPUT_ROOT:-$(pwd)/out}
+WARMUP=${WARMUP:-20}
+THREADS=${THREADS:-0}       # 0 = one worker per hardware thread
+BOOTSTRAP=${BOOTSTRAP:-2000}
+CXX=${CXX:-c++}
+
+if [[ ! -d "${RESULT_ROOT}" ]]; then
+  echo "[ERROR] Result directory not found: ${RESULT_ROOT}" >&2
+  exit 1
+fi
+
+BINARY="${SCRIPT_DIR}/trace_stats"
+if [[ ! -x "${BINARY}" || "${SCRIPT_DIR}/trace_stats.cc" -nt "${BINARY}" ]]; then
+  echo "[INFO] Building ${BINARY}" >&2
+  "${CXX}" -O3 -march=native -std=c++17 -fopenmp-simd -pthread -o "${BINARY}" "${SCRIPT_DIR}/trace_stats.cc"
+fi
+
+"${BINARY}" --root "${RESULT_ROOT}" --out "${OUTPUT_ROOT}" --warmup "${WARMUP}" --threads "${THREADS}" \
+  --bootstrap "${BOOTSTRAP}"
@@ -0,0 +1,110 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Compares the fluid-model estimates written by run_tcp_matrix.sh (SCREEN=order|skip)
+# with the packet-level results, per {scenario, tcp, loss}. The ns-3 side is computed
+# like the fluid model: over data flows only (TCP bulk transfers and UDP cross traffic),
+# leaving out the reverse ACK flow FlowMonitor records for every TCP connection.
+
+RESULT_ROOT=${RESULT_ROOT:-$HOME/ns-3/results}
+SCREEN_CSV=${SCREEN_CSV:-${RESULT_ROOT}/screen.csv}
+OUTPUT_ROOT=${OUTPUT_ROOT:-$(pwd)/out}
+WARMUP=${WARMUP:-20}
+QUEUE_SIZE=${QUEUE_SIZE:-150p}
+
+if [[ ! -d "${RESULT_ROOT}" ]]; then
+  echo "[ERROR] Result directory not found: ${RESULT_ROOT}" >&2
+  exit 1
+fi
+if [[ ! -f "${SCREEN_CSV}" ]]; then
+  echo "[ERROR] Fluid estimates not found: ${SCREEN_CSV}" >&2
+  exit 1
+fi
+
+mkdir -p "${OUTPUT_ROOT}"
+VALIDATION_CSV="${OUTPUT_ROOT}/validation.csv"
+RUNS_TMP=$(mktemp)
+trap 'rm -f "${RUNS_TMP}"' EXIT
+
+# One "scenario,tcp,loss,run,total_mbps,jain" line per run. S3 runs live under
+# results/loss-<x>/; every other scenario runs without loss.
+find "${RESULT_ROOT}" -name flowmon.xml | while read -r xml; do
+  run_dir=$(dirname "${xml}")
+  tcp_dir=$(dirname "${run_dir}")
+  scenario_dir=$(dirname "${tcp_dir}")
+  sweep=$(basename "$(dirname "${scenario_dir}")")
+  loss=0
+  if [[ "${sweep}" == loss-* ]]; then
+    loss=${sweep#loss-}
+  fi
+
+  awk -v warmup="${WARMUP}" -v scenario="$(basename "${scenario_dir}")" -v tcp="$(basename "${tcp_dir}")" \
+      -v run="$(basename "${run_dir}" | sed 's/run-//')" -v loss="${loss}" '
+    BEGIN { FS="[=\" ]+"; }
+    /<Flow / {
+      flowId=""; rxBytes=""; tFirst=""; tLast=""; dstPort="";
+      for (i = 1; i <= NF; ++i) {
+        if ($i == "flowId") flowId = $(i+1);
+        if ($i == "rxBytes") rxBytes = $(i+1);
+        if ($i == "destinationPort") dstPort = $(i+1);
+        if ($i == "timeFirstRxPacket") { v = $(i+1); gsub(/^\+|ns$/, "", v); tFirst = v / 1e9; }
+        if ($i == "timeLastRxPacket") { v = $(i+1); gsub(/^\+|ns$/, "", v); tLast = v / 1e9; }
+      }
+      # Data flows go to the fixed sink ports of tcp_compare.cc; ACK flows return to
+      # ephemeral ports (>= 49152).
+      if (dstPort != "") { data[flowId] = (dstPort < 49152); next; }
+      if (flowId != "" && rxBytes != "" && tLast > 0) {
+        duration = tLast - warmup;
+        if (duration <= 0) duration = tLast - tFirst;
+        if (duration > 0 && rxBytes > 0) tput[flowId] = (rxBytes * 8.0) / (duration * 1e6);
+      }
+    }
+    END {
+      sum = 0; sumsq = 0; n = 0;
+      for (f in tput) {
+        if (!data[f]) continue;
+        sum += tput[f]; sumsq += tput[f] * tput[f]; n++;
+      }
+      if (n > 0) printf "%s,%s,%g,%s,%f,%f\n", scenario, tcp, loss, run, sum, (sum * sum) / (n * sumsq);
+    }
+  ' "${xml}"
+done > "${RUNS_TMP}"
+
+awk -F',' -v queue="${QUEUE_SIZE%p}" -v validation_csv="${VALIDATION_CSV}" '
+  FILENAME == ARGV[1] {
+    if (FNR == 1 || $6 == "" || $3 + 0 != queue + 0) next;
+    key = $1 "|" $2 "|" sprintf ("%g", $4);
+    fluidTput[key] = $6; fluidJain[key] = $8;
+    next;
+  }
+  {
+    key = $1 "|" $2 "|" $3;
+    tputSum[key] += $5; jainSum[key] += $6; runs[key]++;
+  }
+  END {
+    print "scenario,tcp,loss,runs,ns3_tput_mbps,fluid_tput_mbps,tput_rel_err,ns3_jain,fluid_jain,jain_abs_err" > validation_csv;
+    close(validation_csv);
+    n = 0;
+    for (key in runs) {
+      if (!(key in fluidTput)) continue;
+      split(key, parts, "|");
+      tput = tputSum[key] / runs[key];
+      jain = jainSum[key] / runs[key];
+      tputErr = (tput > 0) ? (fluidTput[key] - tput) / tput : 0;
+      jainErr = fluidJain[key] - jain;
+      printf "%s,%s,%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n", parts[1], parts[2], parts[3], runs[key], tput,
+             fluidTput[key], tputErr, jain, fluidJain[key], jainErr | "sort -t, -k1,1 -k2,2 -k3,3g >> \"" validation_csv "\"";
+      sumTputErr += (tputErr < 0) ? -tputErr : tputErr;
+      sumJainErr += (jainErr < 0) ? -jainErr : jainErr;
+      n++;
+    }
+    if (n == 0) {
+      print "[WARN] No {scenario,tcp,loss} cell has both fluid and ns-3 results" > "/dev/stderr";
+      exit 0;
+    }
+    printf "[INFO] %d cell(s): mean |throughput error| %.1f%%, mean |Jain error| %.3f\n",
+           n, 100 * sumTputErr / n, sumJainErr / n > "/dev/stderr";
+  }
+' "${SCREEN_CSV}" "${RUNS_TMP}"
+
+echo "[INFO] Fluid-model validation written to ${VALIDATION_CSV}" >&2
@@ -21,8 +21,22 @@
 #include <ns3/onoff-application.h>
 #include <ns3/tcp-socket-base.h>
 
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 using namespace ns3;
@@ -36,24 +50,38 @@ struct RuntimeOptions
   std::string scenario;
   std::string tcpType;
   std::string queueSize;
+  std::string bottleneckRate; // overrides the scenario's bottleneck DataRate when set
   double simulationTime;   // seconds
   double warmupTime;       // seconds to discard in analysis
   uint32_t seed;           // ns-3 RNG stream
   double lossRate;         // used in wireless scenario
   double blockageDuration; // blockage duration for S4 (seconds)
   bool enableFlowMonitor;
+  std::string resultRoot;  // parent directory of the per-run output tree
+  std::string statusFile;  // live progress file (defaults to <outputDir>/status)
+  double progressInterval; // simulated seconds between status updates, 0 disables
+  double shortFlowRate;    // short-flow (web) arrivals/s per direction in S2/S5; default ~2 Mbps
+  std::string shortFlowCdf; // flow size CDF file ("bytes probability" lines), empty = built-in
+  uint32_t shortFlowPool;  // maximum concurrent short flows per client
 };
 
 RuntimeOptions::RuntimeOptions ()
     : scenario ("S1"),
       tcpType ("TcpCubic"),
       queueSize ("150p"),
+      bottleneckRate (""),
       simulationTime (120.0),
       warmupTime (20.0),
       seed (1),
       lossRate (0.0),
       blockageDuration (0.2),
-      enableFlowMonitor (true)
+      enableFlowMonitor (true),
+      resultRoot ("results"),
+      statusFile (""),
+      progressInterval (1.0),
+      shortFlowRate (2.4),
+      shortFlowCdf (""),
+      shortFlowPool (256)
 {
 }
 
@@ -61,11 +89,17 @@ static std::string
 CreateOutputDir (const RuntimeOptions &opts)
 {
   std::string dir =
-      "results/" + opts.scenario + "/" + opts.tcpType + "/run-" + std::to_string (opts.seed);
+      opts.resultRoot + "/" + opts.scenario + "/" + opts.tcpType + "/run-" + std::to_string (opts.seed);
   SystemPath::MakeDirectories (dir.c_str ());
   return dir;
 }
 
+static std::string
+BottleneckRate (const RuntimeOptions &opts, const std::string &scenarioDefault)
+{
+  return opts.bottleneckRate.empty () ? scenarioDefault : opts.bottleneckRate;
+}
+
 static void
 ConfigureTcp (const std::string &tcpType)
 {
@@ -198,6 +232,148 @@ SerializeFlowMonitor (Ptr<FlowMonitor> monitor, const std::string &path)
   monitor->SerializeToXmlFile (path, true, true);
 }
 
+static uint64_t
+PeakRssKb ()
+{
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage) != 0)
+    {
+      return 0;
+    }
+#ifdef __APPLE__
+  return static_cast<uint64_t> (usage.ru_maxrss) / 1024; // bytes on macOS
+#else
+  return static_cast<uint64_t> (usage.ru_maxrss); // kilobytes on Linux
+#endif
+}
+
+static uint64_t
+CurrentRssKb ()
+{
+  std::ifstream statm ("/proc/self/statm");
+  uint64_t sizePages = 0;
+  uint64_t residentPages = 0;
+  if (statm >> sizePages >> residentPages)
+    {
+      return residentPages * static_cast<uint64_t> (sysconf (_SC_PAGESIZE)) / 1024;
+    }
+  return PeakRssKb (); // no procfs (macOS): fall back to the high-water mark
+}
+
+// State for the periodic status report written while Simulator::Run is active.
+struct ProgressState
+{
+  std::string path;
+  double interval = 0.0;
+  double simulationTime = 0.0;
+  Ptr<FlowMonitor> monitor;
+  std::chrono::steady_clock::time_point wallStart;
+  std::chrono::steady_clock::time_point lastWall;
+  uint64_t lastEvents = 0;
+  double lastSimTime = 0.0;
+  std::map<FlowId, uint64_t> lastRxBytes;
+};
+
+static ProgressState g_progress;
+
+// Rewrites the status file atomically (write to a temp file, then rename) so readers
+// such as tools/run_tcp_matrix.sh never observe a partially written line.
+static void
+WriteStatus (const std::string &state)
+{
+  const auto wallNow = std::chrono::steady_clock::now ();
+  const double simNow = Simulator::Now ().GetSeconds ();
+  const double wallElapsed = std::chrono::duration<double> (wallNow - g_progress.wallStart).count ();
+  const double wallDelta = std::chrono::duration<double> (wallNow - g_progress.lastWall).count ();
+  const double simDelta = simNow - g_progress.lastSimTime;
+  const uint64_t events = Simulator::GetEventCount ();
+
+  const double eventsPerSec = wallDelta > 0.0 ? (events - g_progress.lastEvents) / wallDelta : 0.0;
+  const double eta = simNow > 0.0 ? (g_progress.simulationTime - simNow) * wallElapsed / simNow : -1.0;
+
+  std::ostringstream line;
+  line << "state=" << state << " sim=" << simNow << " total=" << g_progress.simulationTime
+       << " pct=" << (g_progress.simulationTime > 0.0 ? 100.0 * simNow / g_progress.simulationTime : 0.0)
+       << " wall=" << wallElapsed << " eps=" << eventsPerSec << " eta=" << eta
+       << " rss_kb=" << CurrentRssKb () << " flows=";
+
+  // Per-flow goodput over the last interval, flowId:Mbps pairs
+  bool first = true;
+  if (g_progress.monitor)
+    {
+      for (const auto &entry : g_progress.monitor->GetFlowStats ())
+        {
+          uint64_t &lastRx = g_progress.lastRxBytes[entry.first];
+          const double mbps = simDelta > 0.0 ? (entry.second.rxBytes - lastRx) * 8.0 / simDelta / 1e6 : 0.0;
+          lastRx = entry.second.rxBytes;
+          line << (first ? "" : ",") << entry.first << ":" << mbps;
+          first = false;
+        }
+    }
+  if (first)
+    {
+      line << "-";
+    }
+
+  const std::string tmpPath = g_progress.path + ".tmp";
+  {
+    std::ofstream out (tmpPath, std::ios::trunc);
+    out << line.str () << std::endl;
+  }
+  std::rename (tmpPath.c_str (), g_progress.path.c_str ());
+
+  g_progress.lastWall = wallNow;
+  g_progress.lastEvents = events;
+  g_progress.lastSimTime = simNow;
+}
+
+static void
+ReportProgress ()
+{
+  WriteStatus ("running");
+  Simulator::Schedule (Seconds (g_progress.interval), &ReportProgress);
+}
+
+// Runs the event loop and records host-side cost (wall clock, events/s, peak RSS)
+// to perf.csv so tools/bench_tcp_compare.sh can track performance regressions.
+// While running, a low-frequency event publishes progress to the status file.
+static void
+RunSimulation (const RuntimeOptions &opts, const std::string &outputDir, Ptr<FlowMonitor> monitor)
+{
+  Simulator::Stop (Seconds (opts.simulationTime));
+
+  const auto wallStart = std::chrono::steady_clock::now ();
+  const bool reportProgress = opts.progressInterval > 0.0;
+  if (reportProgress)
+    {
+      g_progress = ProgressState ();
+      g_progress.path = opts.statusFile.empty () ? outputDir + "/status" : opts.statusFile;
+      g_progress.interval = opts.progressInterval;
+      g_progress.simulationTime = opts.simulationTime;
+      g_progress.monitor = monitor;
+      g_progress.wallStart = wallStart;
+      g_progress.lastWall = wallStart;
+      Simulator::ScheduleNow (&ReportProgress);
+    }
+
+  Simulator::Run ();
+  const double wallSeconds =
+      std::chrono::duration<double> (std::chrono::steady_clock::now () - wallStart).count ();
+
+  if (reportProgress)
+    {
+      WriteStatus ("done");
+      g_progress.monitor = nullptr;
+    }
+
+  const uint64_t events = Simulator::GetEventCount ();
+  std::ofstream perf (outputDir + "/perf.csv");
+  perf << "scenario,tcp,run,sim_time_s,wall_s,events,events_per_s,peak_rss_kb" << std::endl;
+  perf << opts.scenario << "," << opts.tcpType << "," << opts.seed << "," << opts.simulationTime << ","
+       << wallSeconds << "," << events << "," << (wallSeconds > 0.0 ? events / wallSeconds : 0.0) << ","
+       << PeakRssKb () << std::endl;
+}
+
 static void
 SetOnOffRate (Ptr<OnOffApplication> app, const std::string &rate)
 {
@@ -248,23 +424,526 @@ InstallBulkTransfers (PointToPointDumbbellHelper &dumbbell, double start, double
   return allApps;
 }
 
+// Streaming histogram of flow completion times: log-spaced buckets (20 per decade
+// from 10 us to 1000 s) keep memory fixed regardless of how many flows complete.
+class FctHistogram
+{
+public:
+  void Add (double seconds);
+  double GetQuantile (double q) const;
+  uint64_t GetCount () const { return m_count; }
+  double GetMean () const { return m_count > 0 ? m_sum / m_count : 0.0; }
+  double GetMax () const { return m_max; }
+
+private:
+  static constexpr double kMinSeconds = 1e-5;
+  static constexpr uint32_t kBucketsPerDecade = 20;
+  static constexpr uint32_t kBuckets = 8 * kBucketsPerDecade + 2; // plus underflow and overflow
+
+  static uint32_t BucketOf (double seconds);
+  static double BucketMidpoint (uint32_t bucket);
+
+  std::array<uint64_t, kBuckets> m_buckets{};
+  uint64_t m_count = 0;
+  double m_sum = 0.0;
+  double m_max = 0.0;
+};
+
+void
+FctHistogram::Add (double seconds)
+{
+  ++m_buckets[BucketOf (seconds)];
+  ++m_count;
+  m_sum += seconds;
+  m_max = std::max (m_max, seconds);
+}
+
+double
+FctHistogram::GetQuantile (double q) const
+{
+  const uint64_t rank = std::max<uint64_t> (1, static_cast<uint64_t> (std::ceil (q * m_count)));
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < kBuckets; ++i)
+    {
+      seen += m_buckets[i];
+      if (seen >= rank)
+        {
+          return std::min (BucketMidpoint (i), m_max);
+        }
+    }
+  return m_max;
+}
+
+uint32_t
+FctHistogram::BucketOf (double seconds)
+{
+  if (seconds < kMinSeconds)
+    {
+      return 0;
+    }
+  const double offset = std::log10 (seconds / kMinSeconds) * kBucketsPerDecade;
+  return std::min (kBuckets - 1, 1 + static_cast<uint32_t> (offset));
+}
+
+double
+FctHistogram::BucketMidpoint (uint32_t bucket)
+{
+  if (bucket == 0)
+    {
+      return kMinSeconds;
+    }
+  return kMinSeconds * std::pow (10.0, (bucket - 0.5) / kBucketsPerDecade);
+}
+
+// Counters and per-size-class FCT histograms shared by the short-flow applications.
+struct ShortFlowStats
+{
+  static const uint32_t kSizeClasses = 4;
+
+  static uint32_t SizeClassOf (uint32_t bytes);
+  static const char *SizeClassName (uint32_t sizeClass);
+
+  FctHistogram fct[kSizeClasses];
+  uint64_t arrivals = 0;
+  uint64_t completed = 0;
+  uint64_t failed = 0;
+  uint64_t dropped = 0; // arrivals rejected because the backlog was full
+  uint64_t rxBytes = 0;
+};
+
+uint32_t
+ShortFlowStats::SizeClassOf (uint32_t bytes)
+{
+  if (bytes <= 10 * 1024)
+    {
+      return 0;
+    }
+  if (bytes <= 100 * 1024)
+    {
+      return 1;
+    }
+  return bytes <= 1024 * 1024 ? 2 : 3;
+}
+
+const char *
+ShortFlowStats::SizeClassName (uint32_t sizeClass)
+{
+  static const char *const names[kSizeClasses] = {"<=10KB", "10KB-100KB", "100KB-1MB", ">1MB"};
+  return names[sizeClass];
+}
+
 static void
-InstallShortWebTraffic (Ptr<Node> client, Ptr<Node> server, Ipv4Address serverAddress, double start, double stop)
+WriteShortFlowStats (const ShortFlowStats &stats, const std::string &outputDir)
+{
+  std::ofstream fct (outputDir + "/fct.csv");
+  fct << "size_class,flows,mean_s,p50_s,p95_s,p99_s,max_s" << std::endl;
+  for (uint32_t c = 0; c < ShortFlowStats::kSizeClasses; ++c)
+    {
+      const FctHistogram &h = stats.fct[c];
+      fct << ShortFlowStats::SizeClassName (c) << "," << h.GetCount () << "," << h.GetMean () << ","
+          << h.GetQuantile (0.5) << "," << h.GetQuantile (0.95) << "," << h.GetQuantile (0.99) << ","
+          << h.GetMax () << std::endl;
+    }
+
+  std::ofstream summary (outputDir + "/shortflows.csv");
+  summary << "arrivals,completed,failed,dropped,unfinished,rx_bytes" << std::endl;
+  summary << stats.arrivals << "," << stats.completed << "," << stats.failed << "," << stats.dropped << ","
+          << stats.arrivals - stats.completed - stats.failed - stats.dropped << "," << stats.rxBytes
+          << std::endl;
+}
+
+// Opens short TCP transfers with Poisson arrivals and sizes drawn from an empirical CDF.
+// Per-flow state lives in a fixed pool of slots; arrivals that find the pool busy wait
+// in a bounded backlog. ns-3 TCP sockets cannot reconnect once closed, so each flow gets
+// a fresh socket that is released as soon as the transfer has been acknowledged.
+class ShortFlowClient : public Application
+{
+public:
+  static TypeId GetTypeId ();
+
+  void Setup (const Address &peer, double flowsPerSecond, Ptr<RandomVariableStream> flowSize,
+              uint32_t poolSize, ShortFlowStats *stats);
+
+private:
+  struct FlowSlot
+  {
+    Ptr<Socket> socket;
+    uint32_t size = 0;
+    uint32_t sent = 0;
+    Time start; // arrival time, so the FCT includes any wait in the backlog
+  };
+
+  static const uint32_t kBacklogPerSlot = 4;
+  // The client closes first, so every finished flow passes through TIME_WAIT (2 x MSL).
+  // With the default 120 s MSL no socket or ephemeral port would be freed within a run;
+  // 0.5 s still spans several RTTs of every scenario.
+  static constexpr double kMaxSegLifetime = 0.5;
+
+  void StartApplication () override;
+  void StopApplication () override;
+
+  void ScheduleArrival ();
+  void HandleArrival ();
+  bool OpenFlow (uint32_t slot, uint32_t size, Time arrival);
+  void HandleConnected (Ptr<Socket> socket);
+  void HandleConnectFailed (Ptr<Socket> socket);
+  void HandleSend (Ptr<Socket> socket, uint32_t available);
+  void HandleError (Ptr<Socket> socket);
+  void CloseFlow (uint32_t slot);
+  void ReleaseFlow (uint32_t slot);
+
+  Address m_peer;
+  Ptr<ExponentialRandomVariable> m_interArrival;
+  Ptr<RandomVariableStream> m_flowSize;
+  ShortFlowStats *m_stats = nullptr;
+  std::vector<FlowSlot> m_slots;
+  std::vector<uint32_t> m_freeSlots;
+  std::deque<std::pair<uint32_t, Time>> m_backlog; // {size, arrival} waiting for a free slot
+  std::unordered_map<Socket *, uint32_t> m_slotOf;
+  EventId m_arrivalEvent;
+  uint32_t m_sndBufSize = 0;
+  bool m_running = false;
+};
+
+TypeId
+ShortFlowClient::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ShortFlowClient").SetParent<Application> ().AddConstructor<ShortFlowClient> ();
+  return tid;
+}
+
+void
+ShortFlowClient::Setup (const Address &peer, double flowsPerSecond, Ptr<RandomVariableStream> flowSize,
+                        uint32_t poolSize, ShortFlowStats *stats)
+{
+  NS_ABORT_MSG_IF (flowsPerSecond <= 0.0 || poolSize == 0, "Short-flow rate and pool size must be positive");
+  m_peer = peer;
+  m_flowSize = flowSize;
+  m_stats = stats;
+  m_interArrival = CreateObject<ExponentialRandomVariable> ();
+  m_interArrival->SetAttribute ("Mean", DoubleValue (1.0 / flowsPerSecond));
+  m_slots.assign (poolSize, FlowSlot ());
+  m_freeSlots.clear ();
+  for (uint32_t i = poolSize; i > 0; --i)
+    {
+      m_freeSlots.push_back (i - 1);
+    }
+}
+
+void
+ShortFlowClient::StartApplication ()
 {
-  uint16_t port = 9000;
-  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
-  ApplicationContainer sinkApp = sinkHelper.Install (server);
-  sinkApp.Start (Seconds (start));
-  sinkApp.Stop (Seconds (stop));
+  m_running = true;
+  ScheduleArrival ();
+}
 
-  OnOffHelper httpHelper ("ns3::TcpSocketFactory", Address (InetSocketAddress (serverAddress, port)));
-  httpHelper.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=0.2]"));
-  httpHelper.SetAttribute ("OffTime", StringValue ("ns3::ExponentialRandomVariable[Mean=0.8]"));
-  httpHelper.SetAttribute ("PacketSize", UintegerValue (1200));
-  httpHelper.SetAttribute ("DataRate", DataRateValue (DataRate ("10Mbps")));
-  ApplicationContainer clientApp = httpHelper.Install (client);
-  clientApp.Start (Seconds (start + 1.0));
-  clientApp.Stop (Seconds (stop));
+void
+ShortFlowClient::StopApplication ()
+{
+  m_running = false;
+  Simulator::Cancel (m_arrivalEvent);
+  m_backlog.clear ();
+  for (uint32_t slot = 0; slot < m_slots.size (); ++slot)
+    {
+      if (m_slots[slot].socket)
+        {
+          ReleaseFlow (slot);
+        }
+    }
+}
+
+void
+ShortFlowClient::ScheduleArrival ()
+{
+  m_arrivalEvent = Simulator::Schedule (Seconds (m_interArrival->GetValue ()), &ShortFlowClient::HandleArrival, this);
+}
+
+void
+ShortFlowClient::HandleArrival ()
+{
+  ++m_stats->arrivals;
+  const uint32_t size = std::max<uint32_t> (1, m_flowSize->GetInteger ());
+  if (!m_freeSlots.empty ())
+    {
+      const uint32_t slot = m_freeSlots.back ();
+      m_freeSlots.pop_back ();
+      if (!OpenFlow (slot, size, Simulator::Now ()))
+        {
+          m_freeSlots.push_back (slot);
+        }
+    }
+  else if (m_backlog.size () < kBacklogPerSlot * m_slots.size ())
+    {
+      m_backlog.emplace_back (size, Simulator::Now ());
+    }
+  else
+    {
+      ++m_stats->dropped;
+    }
+  ScheduleArrival ();
+}
+
+// Starts a flow in a free slot. The FCT is measured from the arrival, so time spent in
+// the backlog counts. Returns false (flow counted as failed) if the socket cannot be
+// bound or connected, e.g. when ephemeral ports run out.
+bool
+ShortFlowClient::OpenFlow (uint32_t slot, uint32_t size, Time arrival)
+{
+  FlowSlot &flow = m_slots[slot];
+  flow.socket = Socket::CreateSocket (GetNode (), TcpSocketFactory::GetTypeId ());
+  flow.socket->SetAttribute ("MaxSegLifetime", DoubleValue (kMaxSegLifetime));
+  flow.size = size;
+  flow.sent = 0;
+  flow.start = arrival;
+  if (m_sndBufSize == 0)
+    {
+      UintegerValue sndBufSize;
+      flow.socket->GetAttribute ("SndBufSize", sndBufSize);
+      m_sndBufSize = sndBufSize.Get ();
+    }
+  m_slotOf[PeekPointer (flow.socket)] = slot;
+
+  if (flow.socket->Bind () != 0)
+    {
+      ++m_stats->failed;
+      CloseFlow (slot);
+      return false;
+    }
+  flow.socket->SetConnectCallback (MakeCallback (&ShortFlowClient::HandleConnected, this),
+                                   MakeCallback (&ShortFlowClient::HandleConnectFailed, this));
+  flow.socket->SetSendCallback (MakeCallback (&ShortFlowClient::HandleSend, this));
+  flow.socket->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket>> (),
+                                  MakeCallback (&ShortFlowClient::HandleError, this));
+  if (flow.socket->Connect (m_peer) != 0)
+    {
+      ++m_stats->failed;
+      CloseFlow (slot);
+      return false;
+    }
+  return true;
+}
+
+void
+ShortFlowClient::HandleConnected (Ptr<Socket> socket)
+{
+  HandleSend (socket, socket->GetTxAvailable ());
+}
+
+void
+ShortFlowClient::HandleConnectFailed (Ptr<Socket> socket)
+{
+  HandleError (socket);
+}
+
+void
+ShortFlowClient::HandleSend (Ptr<Socket> socket, uint32_t available)
+{
+  auto it = m_slotOf.find (PeekPointer (socket));
+  if (it == m_slotOf.end ())
+    {
+      return;
+    }
+  const uint32_t slot = it->second;
+  FlowSlot &flow = m_slots[slot];
+  while (flow.sent < flow.size && available > 0)
+    {
+      const uint32_t chunk = std::min (flow.size - flow.sent, available);
+      if (socket->Send (Create<Packet> (chunk)) < 0)
+        {
+          break;
+        }
+      flow.sent += chunk;
+      available = socket->GetTxAvailable ();
+    }
+
+  // The send buffer is back to its full size once every byte has been acknowledged
+  if (flow.sent == flow.size && socket->GetTxAvailable () >= m_sndBufSize)
+    {
+      ++m_stats->completed;
+      m_stats->fct[ShortFlowStats::SizeClassOf (flow.size)].Add ((Simulator::Now () - flow.start).GetSeconds ());
+      ReleaseFlow (slot);
+    }
+}
+
+void
+ShortFlowClient::HandleError (Ptr<Socket> socket)
+{
+  auto it = m_slotOf.find (PeekPointer (socket));
+  if (it == m_slotOf.end ())
+    {
+      return;
+    }
+  ++m_stats->failed;
+  ReleaseFlow (it->second);
+}
+
+void
+ShortFlowClient::CloseFlow (uint32_t slot)
+{
+  FlowSlot &flow = m_slots[slot];
+  m_slotOf.erase (PeekPointer (flow.socket));
+  flow.socket->SetConnectCallback (MakeNullCallback<void, Ptr<Socket>> (), MakeNullCallback<void, Ptr<Socket>> ());
+  flow.socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+  flow.socket->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket>> (), MakeNullCallback<void, Ptr<Socket>> ());
+  flow.socket->Close ();
+  flow.socket = nullptr;
+}
+
+// Closes the slot's socket and hands the slot to the oldest backlogged arrival.
+void
+ShortFlowClient::ReleaseFlow (uint32_t slot)
+{
+  CloseFlow (slot);
+  while (m_running && !m_backlog.empty ())
+    {
+      const std::pair<uint32_t, Time> next = m_backlog.front ();
+      m_backlog.pop_front ();
+      if (OpenFlow (slot, next.first, next.second))
+        {
+          return;
+        }
+    }
+  m_freeSlots.push_back (slot);
+}
+
+// Drains short flows and closes each accepted socket when the peer closes, so finished
+// connections do not linger in CLOSE_WAIT (PacketSink keeps every accepted socket).
+class ShortFlowServer : public Application
+{
+public:
+  static TypeId GetTypeId ();
+
+  void Setup (uint16_t port, ShortFlowStats *stats);
+
+private:
+  void StartApplication () override;
+  void StopApplication () override;
+
+  void HandleAccept (Ptr<Socket> socket, const Address &from);
+  void HandleRead (Ptr<Socket> socket);
+  void HandleClose (Ptr<Socket> socket);
+
+  uint16_t m_port = 0;
+  Ptr<Socket> m_listener;
+  ShortFlowStats *m_stats = nullptr;
+};
+
+TypeId
+ShortFlowServer::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ShortFlowServer").SetParent<Application> ().AddConstructor<ShortFlowServer> ();
+  return tid;
+}
+
+void
+ShortFlowServer::Setup (uint16_t port, ShortFlowStats *stats)
+{
+  m_port = port;
+  m_stats = stats;
+}
+
+void
+ShortFlowServer::StartApplication ()
+{
+  m_listener = Socket::CreateSocket (GetNode (), TcpSocketFactory::GetTypeId ());
+  m_listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_port));
+  m_listener->Listen ();
+  m_listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                                 MakeCallback (&ShortFlowServer::HandleAccept, this));
+}
+
+void
+ShortFlowServer::StopApplication ()
+{
+  if (m_listener)
+    {
+      m_listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                                     MakeNullCallback<void, Ptr<Socket>, const Address &> ());
+      m_listener->Close ();
+      m_listener = nullptr;
+    }
+}
+
+void
+ShortFlowServer::HandleAccept (Ptr<Socket> socket, const Address &)
+{
+  socket->SetRecvCallback (MakeCallback (&ShortFlowServer::HandleRead, this));
+  socket->SetCloseCallbacks (MakeCallback (&ShortFlowServer::HandleClose, this),
+                             MakeCallback (&ShortFlowServer::HandleClose, this));
+}
+
+void
+ShortFlowServer::HandleRead (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      if (packet->GetSize () == 0)
+        {
+          break;
+        }
+      m_stats->rxBytes += packet->GetSize ();
+    }
+}
+
+void
+ShortFlowServer::HandleClose (Ptr<Socket> socket)
+{
+  socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket>> ());
+  socket->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket>> (), MakeNullCallback<void, Ptr<Socket>> ());
+  socket->Close ();
+}
+
+static Ptr<EmpiricalRandomVariable>
+CreateFlowSizeDistribution (const std::string &cdfPath)
+{
+  Ptr<EmpiricalRandomVariable> sizes = CreateObject<EmpiricalRandomVariable> ();
+  sizes->SetInterpolate (true);
+  if (cdfPath.empty ())
+    {
+      // Heavy-tailed web object sizes: {bytes, cumulative probability}
+      static const double webCdf[][2] = {
+          {100, 0.0},    {1e3, 0.15},   {2e3, 0.3},    {5e3, 0.5},    {1e4, 0.65},  {3e4, 0.8},
+          {1e5, 0.9},    {3e5, 0.95},   {1e6, 0.98},   {3e6, 0.995},  {1e7, 1.0},
+      };
+      for (const auto &point : webCdf)
+        {
+          sizes->CDF (point[0], point[1]);
+        }
+      return sizes;
+    }
+
+  std::ifstream in (cdfPath);
+  NS_ABORT_MSG_IF (!in, "Cannot open flow size CDF: " << cdfPath);
+  double bytes = 0.0;
+  double probability = 0.0;
+  bool havePoints = false;
+  while (in >> bytes >> probability)
+    {
+      sizes->CDF (bytes, probability);
+      havePoints = true;
+    }
+  NS_ABORT_MSG_IF (!havePoints, "Flow size CDF has no \"bytes probability\" lines: " << cdfPath);
+  return sizes;
+}
+
+static void
+InstallShortFlows (Ptr<Node> client, Ptr<Node> server, Ipv4Address serverAddress, double start, double stop,
+                   const RuntimeOptions &opts, ShortFlowStats *stats)
+{
+  const uint16_t port = 9000;
+  Ptr<ShortFlowServer> sink = CreateObject<ShortFlowServer> ();
+  sink->Setup (port, stats);
+  server->AddApplication (sink);
+  sink->SetStartTime (Seconds (start));
+  sink->SetStopTime (Seconds (stop));
+
+  Ptr<ShortFlowClient> source = CreateObject<ShortFlowClient> ();
+  source->Setup (InetSocketAddress (serverAddress, port), opts.shortFlowRate,
+                 CreateFlowSizeDistribution (opts.shortFlowCdf), opts.shortFlowPool, stats);
+  client->AddApplication (source);
+  source->SetStartTime (Seconds (start + 1.0));
+  source->SetStopTime (Seconds (stop));
 }
 
 static void
@@ -276,7 +955,7 @@ BuildScenarioS1 (const RuntimeOptions &opts)
   access.SetChannelAttribute ("Delay", StringValue ("1ms"));
 
   PointToPointHelper bottleneck;
-  bottleneck.SetDeviceAttribute ("DataRate", StringValue ("20Mbps"));
+  bottleneck.SetDeviceAttribute ("DataRate", StringValue (BottleneckRate (opts, "20Mbps")));
   bottleneck.SetChannelAttribute ("Delay", StringValue ("15ms"));
   bottleneck.SetQueue ("ns3::DropTailQueue<Packet>", "MaxSize", StringValue (opts.queueSize));
 
@@ -311,8 +990,7 @@ BuildScenarioS1 (const RuntimeOptions &opts)
       monitor = flowmonHelper.InstallAll ();
     }
 
-  Simulator::Stop (Seconds (opts.simulationTime));
-  Simulator::Run ();
+  RunSimulation (opts, outputDir, monitor);
 
   if (monitor)
     {
@@ -333,6 +1011,9 @@ BuildScenarioS2 (const RuntimeOptions &opts)
   rightHosts.Create (2);
   NodeContainer routers;
   routers.Create (2); // 0 = left router, 1 = right router
+  // Dedicated short-flow endpoints keep the bulk hosts' FlowMonitor records bounded
+  NodeContainer webHosts;
+  webHosts.Create (2); // 0 = left of the bottleneck, 1 = right
 
   PointToPointHelper fastAccess;
   fastAccess.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
@@ -347,7 +1028,7 @@ BuildScenarioS2 (const RuntimeOptions &opts)
   rightAccess.SetChannelAttribute ("Delay", StringValue ("1ms"));
 
   PointToPointHelper bottleneck;
-  bottleneck.SetDeviceAttribute ("DataRate", StringValue ("20Mbps"));
+  bottleneck.SetDeviceAttribute ("DataRate", StringValue (BottleneckRate (opts, "20Mbps")));
   bottleneck.SetChannelAttribute ("Delay", StringValue ("15ms"));
   bottleneck.SetQueue ("ns3::DropTailQueue<Packet>", "MaxSize", StringValue (opts.queueSize));
 
@@ -356,11 +1037,14 @@ BuildScenarioS2 (const RuntimeOptions &opts)
   NetDeviceContainer right0Devices = rightAccess.Install (routers.Get (1), rightHosts.Get (0));
   NetDeviceContainer right1Devices = rightAccess.Install (routers.Get (1), rightHosts.Get (1));
   NetDeviceContainer backboneDevices = bottleneck.Install (routers.Get (0), routers.Get (1));
+  NetDeviceContainer webLeftDevices = fastAccess.Install (webHosts.Get (0), routers.Get (0));
+  NetDeviceContainer webRightDevices = rightAccess.Install (routers.Get (1), webHosts.Get (1));
 
   InternetStackHelper stack;
   stack.Install (leftHosts);
   stack.Install (rightHosts);
   stack.Install (routers);
+  stack.Install (webHosts);
 
   Ipv4AddressHelper ipv4;
   ipv4.SetBase ("10.1.1.0", "255.255.255.0");
@@ -373,6 +1057,10 @@ BuildScenarioS2 (const RuntimeOptions &opts)
   Ipv4InterfaceContainer right1If = ipv4.Assign (right1Devices);
   ipv4.NewNetwork ();
   Ipv4InterfaceContainer backboneIf = ipv4.Assign (backboneDevices);
+  ipv4.NewNetwork ();
+  Ipv4InterfaceContainer webLeftIf = ipv4.Assign (webLeftDevices);
+  ipv4.NewNetwork ();
+  Ipv4InterfaceContainer webRightIf = ipv4.Assign (webRightDevices);
 
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
@@ -401,9 +1089,12 @@ BuildScenarioS2 (const RuntimeOptions &opts)
       bulkApps.Add (senderApp);
     }
 
-  // Short web-style cross traffic
-  InstallShortWebTraffic (leftHosts.Get (0), rightHosts.Get (1), rightHostAddrs[1], 5.0, opts.simulationTime);
-  InstallShortWebTraffic (rightHosts.Get (0), leftHosts.Get (1), left1If.GetAddress (0), 5.0, opts.simulationTime);
+  // Short web-style cross traffic in both directions across the bottleneck
+  ShortFlowStats shortFlows;
+  InstallShortFlows (webHosts.Get (0), webHosts.Get (1), webRightIf.GetAddress (1), 5.0, opts.simulationTime, opts,
+                     &shortFlows);
+  InstallShortFlows (webHosts.Get (1), webHosts.Get (0), webLeftIf.GetAddress (0), 5.0, opts.simulationTime, opts,
+                     &shortFlows);
 
   AsciiTraceHelper ascii;
   const std::string outputDir = CreateOutputDir (opts);
@@ -422,11 +1113,12 @@ BuildScenarioS2 (const RuntimeOptions &opts)
   Ptr<FlowMonitor> monitor;
   if (opts.enableFlowMonitor)
     {
-      monitor = flowmonHelper.InstallAll ();
+      // Bulk endpoints only: every short flow is a new 5-tuple and would grow the classifier
+      monitor = flowmonHelper.Install (NodeContainer (leftHosts, rightHosts));
     }
 
-  Simulator::Stop (Seconds (opts.simulationTime));
-  Simulator::Run ();
+  RunSimulation (opts, outputDir, monitor);
+  WriteShortFlowStats (shortFlows, outputDir);
 
   if (monitor)
     {
@@ -448,7 +1140,7 @@ BuildScenarioS3 (const RuntimeOptions &opts)
   access.SetChannelAttribute ("Delay", StringValue ("5ms"));
 
   PointToPointHelper bottleneck;
-  bottleneck.SetDeviceAttribute ("DataRate", StringValue ("40Mbps"));
+  bottleneck.SetDeviceAttribute ("DataRate", StringValue (BottleneckRate (opts, "40Mbps")));
   bottleneck.SetChannelAttribute ("Delay", StringValue ("10ms"));
   bottleneck.SetQueue ("ns3::DropTailQueue<Packet>", "MaxSize", StringValue (opts.queueSize));
 
@@ -525,8 +1217,7 @@ BuildScenarioS3 (const RuntimeOptions &opts)
       monitor = flowmonHelper.InstallAll ();
     }
 
-  Simulator::Stop (Seconds (opts.simulationTime));
-  Simulator::Run ();
+  RunSimulation (opts, outputDir, monitor);
 
   if (monitor)
     {
@@ -544,7 +1235,7 @@ BuildScenarioS5 (const RuntimeOptions &opts)
   access.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
   access.SetChannelAttribute ("Delay", StringValue ("2ms"));
 
-  bottleneck.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  bottleneck.SetDeviceAttribute ("DataRate", StringValue (BottleneckRate (opts, "100Mbps")));
   bottleneck.SetChannelAttribute ("Delay", StringValue ("20ms"));
   bottleneck.SetQueue ("ns3::DropTailQueue<Packet>", "MaxSize", StringValue (opts.queueSize));
 
@@ -552,9 +1243,28 @@ BuildScenarioS5 (const RuntimeOptions &opts)
   PointToPointDumbbellHelper dumbbell (nFlows, access, nFlows, access, bottleneck);
   InstallStacks (dumbbell);
   AssignIpv4Addresses (dumbbell);
+
+  // Dedicated short-flow endpoints hanging off the two bottleneck routers
+  NodeContainer webHosts;
+  webHosts.Create (2); // 0 = left of the bottleneck, 1 = right
+  NetDeviceContainer webLeftDevices = access.Install (webHosts.Get (0), dumbbell.GetLeft ());
+  NetDeviceContainer webRightDevices = access.Install (dumbbell.GetRight (), webHosts.Get (1));
+  InternetStackHelper webStack;
+  webStack.Install (webHosts);
+  Ipv4AddressHelper webIp ("10.4.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer webLeftIf = webIp.Assign (webLeftDevices);
+  webIp.NewNetwork ();
+  Ipv4InterfaceContainer webRightIf = webIp.Assign (webRightDevices);
+
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
   ApplicationContainer bulkApps = InstallBulkTransfers (dumbbell, 0.0, opts.simulationTime);
 
+  ShortFlowStats shortFlows;
+  InstallShortFlows (webHosts.Get (0), webHosts.Get (1), webRightIf.GetAddress (1), 5.0, opts.simulationTime, opts,
+                     &shortFlows);
+  InstallShortFlows (webHosts.Get (1), webHosts.Get (0), webLeftIf.GetAddress (0), 5.0, opts.simulationTime, opts,
+                     &shortFlows);
+
   AsciiTraceHelper ascii;
   const std::string outputDir = CreateOutputDir (opts);
   auto cwndStream = ascii.CreateFileStream (outputDir + "/cwnd.csv");
@@ -572,11 +1282,18 @@ BuildScenarioS5 (const RuntimeOptions &opts)
   Ptr<FlowMonitor> monitor;
   if (opts.enableFlowMonitor)
     {
-      monitor = flowmonHelper.InstallAll ();
+      // Bulk endpoints only: every short flow is a new 5-tuple and would grow the classifier
+      NodeContainer bulkHosts;
+      for (uint32_t i = 0; i < nFlows; ++i)
+        {
+          bulkHosts.Add (dumbbell.GetLeft (i));
+          bulkHosts.Add (dumbbell.GetRight (i));
+        }
+      monitor = flowmonHelper.Install (bulkHosts);
     }
 
-  Simulator::Stop (Seconds (opts.simulationTime));
-  Simulator::Run ();
+  RunSimulation (opts, outputDir, monitor);
+  WriteShortFlowStats (shortFlows, outputDir);
 
   if (monitor)
     {
@@ -728,8 +1445,7 @@ BuildScenarioS4 (const RuntimeOptions &opts)
       monitor = flowmonHelper.InstallAll ();
     }
 
-  Simulator::Stop (Seconds (opts.simulationTime));
-  Simulator::Run ();
+  RunSimulation (opts, outputDir, monitor);
 
   if (monitor)
     {
@@ -748,12 +1464,21 @@ main (int argc, char *argv[])
   cmd.AddValue ("scenario", "Scenario identifier (S1, S2, S3, S4, S5)", opts.scenario);
   cmd.AddValue ("tcp", "TCP variant typeId suffix (e.g., TcpCubic, TcpNewReno)", opts.tcpType);
   cmd.AddValue ("queue", "Bottleneck queue MaxSize (e.g., 100p, 1MB)", opts.queueSize);
+  cmd.AddValue ("bottleneckRate", "Bottleneck DataRate override for S1/S2/S3/S5 (e.g., 50Mbps)",
+                opts.bottleneckRate);
   cmd.AddValue ("time", "Simulation duration (s)", opts.simulationTime);
   cmd.AddValue ("warmup", "Warm-up duration ignored in analysis (s)", opts.warmupTime);
   cmd.AddValue ("run", "RNG run number", opts.seed);
   cmd.AddValue ("loss", "Packet loss rate for S3 (0.0-1.0)", opts.lossRate);
   cmd.AddValue ("blockage", "Blockage duration for S4 in seconds", opts.blockageDuration);
   cmd.AddValue ("flowMonitor", "Enable FlowMonitor output", opts.enableFlowMonitor);
+  cmd.AddValue ("webRate", "Short-flow arrivals per second in S2/S5", opts.shortFlowRate);
+  cmd.AddValue ("webCdf", "Short-flow size CDF file of \"bytes probability\" lines", opts.shortFlowCdf);
+  cmd.AddValue ("webPool", "Maximum concurrent short flows per client in S2/S5", opts.shortFlowPool);
+  cmd.AddValue ("resultDir", "Root directory for per-run outputs", opts.resultRoot);
+  cmd.AddValue ("statusFile", "Live progress file (default <outputDir>/status)", opts.statusFile);
+  cmd.AddValue ("progressInterval", "Simulated seconds between progress updates (0 disables)",
+                opts.progressInterval);
   cmd.Parse (argc, argv);
 
   RngSeedManager::SetSeed (1);
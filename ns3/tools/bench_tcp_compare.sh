@@ -0,0 +1,188 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Performance regression benchmark for tcp_compare.cc.
+# Runs pinned, short versions of S1-S5 at a fixed seed, repeats each case BENCH_REPS
+# times and compares the median wall clock, events/s and peak RSS (from perf.csv)
+# against a recorded baseline. Per-flow rxBytes from flowmon.xml must match the
+# baseline exactly so a speedup cannot silently change simulation results.
+#
+# A short-flow soak then runs SOAK_SCENARIO at a high web-flow rate for each duration
+# in SOAK_TIMES: no short flow may fail, and peak RSS must stay flat (the longest run
+# within THRESHOLD of the shortest). Set SOAK_TIMES="" to skip it.
+#
+#   BENCH_MODE=record ns3/tools/bench_tcp_compare.sh   # write/refresh the baseline
+#   ns3/tools/bench_tcp_compare.sh                     # check against the baseline
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+PROJECT_ROOT=$(cd "${SCRIPT_DIR}/.." && pwd)
+NS3_ROOT=${NS3_ROOT:-$HOME/ns-3}
+SCRATCH_PATH="${NS3_ROOT}/scratch"
+PROGRAM_NAME=${PROGRAM_NAME:-tcp_compare}
+BENCH_MODE=${BENCH_MODE:-check}
+# Each case is scenario:simTime:loss:blockage. S4 must run past the 30 s blockage start.
+BENCH_CASES=${BENCH_CASES:-"S1:10:0.0:0.0 S2:10:0.0:0.0 S3:10:0.01:0.0 S4:32:0.0:0.2 S5:10:0.0:0.0"}
+BENCH_TCP=${BENCH_TCP:-TcpCubic}
+BENCH_SEED=${BENCH_SEED:-1}
+BENCH_REPS=${BENCH_REPS:-5}
+QUEUE_SIZE=${QUEUE_SIZE:-150p}
+THRESHOLD=${THRESHOLD:-0.10}
+BASELINE_DIR=${BASELINE_DIR:-${PROJECT_ROOT}/bench}
+BASELINE_CSV="${BASELINE_DIR}/baseline.csv"
+BASELINE_FLOWS_CSV="${BASELINE_DIR}/baseline_flows.csv"
+BENCH_RESULTS=${BENCH_RESULTS:-${NS3_ROOT}/results-bench}
+SOAK_SCENARIO=${SOAK_SCENARIO:-S2}
+SOAK_RATE=${SOAK_RATE:-200}          # short flows/s per direction, 1-10 KB each
+SOAK_TIMES=${SOAK_TIMES:-"60 300"}   # 300 s at 200 flows/s is ~60k flows per client
+
+if [[ ! -d "${NS3_ROOT}" ]]; then
+  echo "[ERROR] ns-3 root directory not found: ${NS3_ROOT}" >&2
+  exit 1
+fi
+
+if [[ "${BENCH_MODE}" != "check" && "${BENCH_MODE}" != "record" ]]; then
+  echo "[ERROR] BENCH_MODE must be 'check' or 'record', got: ${BENCH_MODE}" >&2
+  exit 1
+fi
+
+if [[ "${BENCH_MODE}" == "check" && ! -f "${BASELINE_CSV}" ]]; then
+  echo "[ERROR] Baseline not found: ${BASELINE_CSV} (run with BENCH_MODE=record first)" >&2
+  exit 1
+fi
+
+mkdir -p "${SCRATCH_PATH}"
+cp "${PROJECT_ROOT}/tcp_compare.cc" "${SCRATCH_PATH}/${PROGRAM_NAME}.cc"
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+CURRENT_CSV="${WORK_DIR}/current.csv"
+CURRENT_FLOWS_CSV="${WORK_DIR}/current_flows.csv"
+echo "case,wall_s,events_per_s,peak_rss_kb" > "${CURRENT_CSV}"
+echo "case,flowId,rxBytes" > "${CURRENT_FLOWS_CSV}"
+
+# Prints "flowId,rxBytes" for every flow in a FlowMonitor XML file.
+extract_flow_bytes() {
+  awk '
+    BEGIN { FS="[=\" ]+"; OFS=","; }
+    /<Flow / {
+      flowId=""; rxBytes="";
+      for (i = 1; i <= NF; ++i) {
+        if ($i == "flowId") flowId = $(i+1);
+        if ($i == "rxBytes") rxBytes = $(i+1);
+      }
+      if (flowId != "" && rxBytes != "") print flowId, rxBytes;
+    }
+  ' "$1" | sort -t, -k1,1n
+}
+
+# Prints the median of the numbers read from stdin (one per line).
+median() {
+  sort -g | awk '{ v[NR] = $1 } END { if (NR == 0) exit 1; print (NR % 2) ? v[(NR + 1) / 2] : (v[NR / 2] + v[NR / 2 + 1]) / 2 }'
+}
+
+pushd "${NS3_ROOT}" >/dev/null
+
+./ns3 configure --disable-tests >/dev/null
+./ns3 build >/dev/null
+
+for bench_case in ${BENCH_CASES}; do
+  IFS=: read -r scenario sim_time loss blockage <<< "${bench_case}"
+  case_id="${scenario}-${BENCH_TCP}-t${sim_time}-l${loss}-b${blockage}"
+  run_dir="${BENCH_RESULTS}/${scenario}/${BENCH_TCP}/run-${BENCH_SEED}"
+  samples="${WORK_DIR}/${case_id}.samples"
+  : > "${samples}"
+
+  for rep in $(seq 1 "${BENCH_REPS}"); do
+    echo "[INFO] Bench case=${case_id} rep=${rep}/${BENCH_REPS}" >&2
+    rm -rf "${run_dir}"
+    ./ns3 run --no-build "scratch/${PROGRAM_NAME} --scenario=${scenario} --tcp=${BENCH_TCP} --queue=${QUEUE_SIZE} --run=${BENCH_SEED} --time=${sim_time} --loss=${loss} --blockage=${blockage} --flowMonitor=true --resultDir=${BENCH_RESULTS}" >/dev/null
+    tail -n 1 "${run_dir}/perf.csv" | awk -F',' '{ print $5, $7, $8 }' >> "${samples}"
+
+    extract_flow_bytes "${run_dir}/flowmon.xml" > "${WORK_DIR}/${case_id}.flows.${rep}"
+    if [[ ${rep} -gt 1 ]] && ! cmp -s "${WORK_DIR}/${case_id}.flows.1" "${WORK_DIR}/${case_id}.flows.${rep}"; then
+      echo "[ERROR] ${case_id}: per-flow bytes differ between repetitions; the run is not deterministic" >&2
+      exit 1
+    fi
+  done
+
+  wall=$(awk '{ print $1 }' "${samples}" | median)
+  eps=$(awk '{ print $2 }' "${samples}" | median)
+  rss=$(awk '{ print $3 }' "${samples}" | median)
+  echo "${case_id},${wall},${eps},${rss}" >> "${CURRENT_CSV}"
+  sed "s/^/${case_id},/" "${WORK_DIR}/${case_id}.flows.1" >> "${CURRENT_FLOWS_CSV}"
+done
+
+# Short-flow soak: tens of thousands of small flows per client exercise socket and
+# ephemeral-port reuse; "time peak_rss_kb failed" per duration.
+SOAK_CSV="${WORK_DIR}/soak.txt"
+: > "${SOAK_CSV}"
+if [[ -n "${SOAK_TIMES}" && "${BENCH_MODE}" == "check" ]]; then
+  printf '1000 0.0\n10000 1.0\n' > "${WORK_DIR}/soak_cdf.txt"
+  soak_dir="${BENCH_RESULTS}/${SOAK_SCENARIO}/${BENCH_TCP}/run-${BENCH_SEED}"
+  for sim_time in ${SOAK_TIMES}; do
+    echo "[INFO] Soak ${SOAK_SCENARIO} time=${sim_time}s webRate=${SOAK_RATE}" >&2
+    rm -rf "${soak_dir}"
+    ./ns3 run --no-build "scratch/${PROGRAM_NAME} --scenario=${SOAK_SCENARIO} --tcp=${BENCH_TCP} --queue=${QUEUE_SIZE} --run=${BENCH_SEED} --time=${sim_time} --webRate=${SOAK_RATE} --webCdf=${WORK_DIR}/soak_cdf.txt --flowMonitor=false --resultDir=${BENCH_RESULTS}" >/dev/null
+    echo "${sim_time} $(tail -n 1 "${soak_dir}/perf.csv" | cut -d, -f8) $(tail -n 1 "${soak_dir}/shortflows.csv" | cut -d, -f3)" >> "${SOAK_CSV}"
+  done
+fi
+
+popd >/dev/null
+
+if [[ "${BENCH_MODE}" == "record" ]]; then
+  mkdir -p "${BASELINE_DIR}"
+  cp "${CURRENT_CSV}" "${BASELINE_CSV}"
+  cp "${CURRENT_FLOWS_CSV}" "${BASELINE_FLOWS_CSV}"
+  echo "[INFO] Baseline written to ${BASELINE_CSV} and ${BASELINE_FLOWS_CSV}" >&2
+  exit 0
+fi
+
+status=0
+
+# Performance: wall clock and RSS may grow, and events/s may drop, by at most THRESHOLD.
+awk -F',' -v threshold="${THRESHOLD}" '
+  FNR == 1 { next }
+  NR == FNR { wall[$1] = $2; eps[$1] = $3; rss[$1] = $4; next }
+  {
+    if (!($1 in wall)) {
+      printf "[WARN] %s: no baseline entry, skipped\n", $1 > "/dev/stderr";
+      next;
+    }
+    verdict = "ok";
+    if ($2 > wall[$1] * (1 + threshold)) verdict = "REGRESSION(wall)";
+    if ($3 < eps[$1] * (1 - threshold)) verdict = "REGRESSION(events/s)";
+    if ($4 > rss[$1] * (1 + threshold)) verdict = "REGRESSION(rss)";
+    printf "%-32s wall %8.3fs (base %8.3fs)  events/s %12.0f (base %12.0f)  rss %8d KB (base %8d KB)  %s\n",
+           $1, $2, wall[$1], $3, eps[$1], $4, rss[$1], verdict;
+    if (verdict != "ok") failed = 1;
+  }
+  END { exit failed }
+' "${BASELINE_CSV}" "${CURRENT_CSV}" || status=1
+
+# Soak: no failed short flows, and peak RSS independent of the run length.
+if [[ -s "${SOAK_CSV}" ]]; then
+  sort -n "${SOAK_CSV}" | awk -v threshold="${THRESHOLD}" '
+    NR == 1 { baseRss = $2 }
+    {
+      verdict = "ok";
+      if ($3 > 0) verdict = "FAILED_FLOWS";
+      if ($2 > baseRss * (1 + threshold)) verdict = "REGRESSION(rss growth)";
+      printf "soak %-24s rss %8d KB (shortest run %8d KB)  failed flows %d  %s\n", $1 "s", $2, baseRss, $3, verdict;
+      if (verdict != "ok") failed = 1;
+    }
+    END { exit failed }
+  ' || status=1
+fi
+
+# Correctness: per-flow received bytes must be identical to the baseline.
+if ! diff <(tail -n +2 "${BASELINE_FLOWS_CSV}" | sort) <(tail -n +2 "${CURRENT_FLOWS_CSV}" | sort) >&2; then
+  echo "[ERROR] Per-flow rxBytes differ from baseline (< baseline, > current)" >&2
+  status=1
+fi
+
+if [[ ${status} -ne 0 ]]; then
+  echo "[ERROR] Benchmark check failed (threshold ${THRESHOLD})" >&2
+else
+  echo "[INFO] Benchmark check passed (threshold ${THRESHOLD})" >&2
+fi
+exit ${status}
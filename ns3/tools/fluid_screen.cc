@@ -0,0 +1,533 @@
+// Fluid-model screening for the wired scenarios of tcp_compare.cc (used by run_tcp_matrix.sh).
+//
+// Each {scenario, tcp, queue, loss} cell is integrated as a hybrid fluid model: flows
+// send W/RTT into a shared DropTail bottleneck whose queue evolves as
+// dq/dt = sum(rate) - C. Overflow and random loss accumulate per flow as expected loss
+// counts; each whole loss is one congestion event (at most one per RTT). Between events
+// the window grows at the variant's fluid rate (Reno/NewReno, Cubic, HighSpeed, Hybla).
+// A cell takes milliseconds, so the whole matrix can be screened before any packet-level run.
+//
+// The topologies mirror BuildScenarioS1/S2/S3/S5 (S4 is LTE and is not modelled).
+// RTOs and delayed ACKs are ignored. Flows sharing an RTT would stay in lockstep in a
+// deterministic model, so each flow starts at a different phase of its first RTT and of
+// its loss process. S2/S5 also carry the short-flow workload, whose FCT the model cannot
+// estimate; their cells are reported but never marked predictable.
+//
+//   fluid_screen --scenarios "S1 S3" --tcp "TcpNewReno TcpCubic" --queue 150p --loss "0.0 0.01"
+//                [--rate 20] [--time 120] [--warmup 20] [--tolerance 0.05]
+//
+// Prints one CSV row per cell. Cells sharing {scenario, queue, loss} form a group; the
+// group is "predictable" when every variant's estimated TCP throughput lies within
+// --tolerance (relative) and Jain's index within --tolerance (absolute) of the others,
+// i.e. the model expects the variants not to differ there.
+// Throughputs use the analysis/aggregate.sh definition (bytes received over the whole
+// run divided by the time after --warmup), so they can be compared with ns-3 directly.
+//
+// Build: c++ -O2 -std=c++17 -o fluid_screen fluid_screen.cc
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const double kPacketBytes = 1500.0;                     // IP size of a full TCP segment
+const double kMaxWindow = 4.0 * 1024 * 1024 / 1448.0;  // SndBufSize / RcvBufSize in segments
+const double kInitialWindow = 10.0;
+const double kStep = 0.0005;                            // integration step (s)
+
+struct Topology
+{
+  std::string id;
+  double bottleneckMbps;
+  std::vector<double> flowRtt; // two-way propagation delay per TCP flow (s)
+  double udpMbps;              // constant-bit-rate cross traffic through the bottleneck
+  double udpStart;
+  double udpPacketBytes;
+  bool hasLoss;                // --loss applies (error model on the bottleneck)
+  bool shortFlows;             // carries the S2/S5 short-flow workload (never predictable)
+};
+
+// Link parameters from BuildScenarioS1/S2/S3/S5; RTT = 2 x (access + bottleneck + access).
+bool
+LookupTopology (const std::string &id, Topology &topo)
+{
+  if (id == "S1")
+    {
+      topo = {id, 20.0, {0.034, 0.034}, 0.0, 0.0, 0.0, false, false};
+    }
+  else if (id == "S2")
+    {
+      topo = {id, 20.0, {0.034, 0.152}, 0.0, 0.0, 0.0, false, true};
+    }
+  else if (id == "S3")
+    {
+      topo = {id, 40.0, {0.040}, 15.0, 5.0, 1228.0, true, false};
+    }
+  else if (id == "S5")
+    {
+      topo = {id, 100.0, std::vector<double> (8, 0.048), 0.0, 0.0, 0.0, false, true};
+    }
+  else
+    {
+      return false;
+    }
+  return true;
+}
+
+enum class Variant
+{
+  NewReno,
+  Cubic,
+  HighSpeed,
+  Hybla,
+  Unsupported
+};
+
+Variant
+ParseVariant (const std::string &tcp)
+{
+  if (tcp == "TcpNewReno")
+    {
+      return Variant::NewReno;
+    }
+  if (tcp == "TcpCubic")
+    {
+      return Variant::Cubic;
+    }
+  if (tcp == "TcpHighSpeed")
+    {
+      return Variant::HighSpeed;
+    }
+  if (tcp == "TcpHybla")
+    {
+      return Variant::Hybla;
+    }
+  return Variant::Unsupported;
+}
+
+// RFC 3649 HighSpeed TCP response function (window in segments).
+double
+HighSpeedDecrease (double w)
+{
+  if (w <= 38.0)
+    {
+      return 0.5;
+    }
+  return (0.1 - 0.5) * (std::log (w) - std::log (38.0)) / (std::log (83000.0) - std::log (38.0)) + 0.5;
+}
+
+double
+HighSpeedIncrease (double w)
+{
+  if (w <= 38.0)
+    {
+      return 1.0;
+    }
+  const double b = HighSpeedDecrease (w);
+  const double p = 0.078 / std::pow (w, 1.2);
+  return w * w * p * 2.0 * b / (2.0 - b);
+}
+
+struct Flow
+{
+  double rtt0 = 0.0;
+  double start = 0.0;
+  double w = kInitialWindow;
+  double ssthresh = kMaxWindow;
+  double lossCredit = 0.0;
+  double recoverUntil = 0.0;
+  // Cubic epoch
+  double wMax = 0.0;
+  double epochStart = 0.0;
+  double k = 0.0;
+  // Results
+  double deliveredBytes = 0.0;
+};
+
+struct CellResult
+{
+  double tputMbps = 0.0;    // all flows, including UDP cross traffic (aggregate.sh definition)
+  double tcpTputMbps = 0.0; // TCP flows only
+  double jain = 0.0;        // over the data flows (TCP and UDP); ACK flows are not modelled
+  double queueDelayMs = 0.0;
+  double lossRate = 0.0;
+};
+
+void
+OnCongestionEvent (Flow &f, Variant variant, double now)
+{
+  switch (variant)
+    {
+    case Variant::Cubic:
+      {
+        const double beta = 0.7; // ns-3 TcpCubic Beta
+        const double c = 0.4;
+        f.wMax = f.w;
+        f.w = std::max (1.0, f.w * beta);
+        f.k = std::cbrt (f.wMax * (1.0 - beta) / c);
+        f.epochStart = now;
+        break;
+      }
+    case Variant::HighSpeed:
+      f.w = std::max (1.0, f.w * (1.0 - HighSpeedDecrease (f.w)));
+      break;
+    default:
+      f.w = std::max (1.0, f.w * 0.5);
+      break;
+    }
+  f.ssthresh = f.w;
+}
+
+void
+GrowWindow (Flow &f, Variant variant, double rtt, double now, double dt)
+{
+  const double rho = std::max (1.0, f.rtt0 / 0.025); // Hybla reference RTT 25 ms
+  if (f.w < f.ssthresh)
+    {
+      // Slow start: +1 segment per ACK (Hybla: 2^rho - 1)
+      const double perAck = variant == Variant::Hybla ? std::pow (2.0, rho) - 1.0 : 1.0;
+      f.w += perAck * f.w / rtt * dt;
+    }
+  else
+    {
+      switch (variant)
+        {
+        case Variant::Cubic:
+          {
+            const double beta = 0.7;
+            const double c = 0.4;
+            const double t = now - f.epochStart;
+            const double cubic = c * std::pow (t - f.k, 3.0) + f.wMax;
+            const double friendly = f.wMax * beta + 3.0 * (1.0 - beta) / (1.0 + beta) * t / rtt;
+            const double target = std::max (cubic, friendly);
+            f.w = std::min (std::max (f.w, target), f.w + f.w / rtt * dt);
+            break;
+          }
+        case Variant::HighSpeed:
+          f.w += HighSpeedIncrease (f.w) / rtt * dt;
+          break;
+        case Variant::Hybla:
+          f.w += rho * rho / rtt * dt;
+          break;
+        default:
+          f.w += 1.0 / rtt * dt;
+          break;
+        }
+    }
+  f.w = std::min (f.w, kMaxWindow);
+}
+
+CellResult
+SimulateCell (const Topology &topo, Variant variant, double queuePackets, double loss, double rateMbps,
+              double simTime, double warmup)
+{
+  const double capacity = rateMbps * 1e6 / 8.0; // bytes/s
+  const double buffer = queuePackets * kPacketBytes;
+  std::vector<Flow> flows (topo.flowRtt.size ());
+  // Spread the flows over one RTT and over the loss process so that flows with the
+  // same RTT do not see every congestion event at the same instant.
+  for (size_t i = 0; i < flows.size (); ++i)
+    {
+      const double phase = static_cast<double> (i) / flows.size ();
+      flows[i].rtt0 = topo.flowRtt[i];
+      flows[i].start = phase * topo.flowRtt[i];
+      flows[i].lossCredit = phase;
+    }
+
+  double queue = 0.0;
+  double udpDelivered = 0.0;
+  double queueTime = 0.0;
+  double measuredTime = 0.0;
+  double offered = 0.0;
+  double dropped = 0.0;
+  std::vector<double> rate (flows.size ());
+
+  for (double now = 0.0; now < simTime; now += kStep)
+    {
+      const double queueingDelay = queue / capacity;
+      double arrival = 0.0;
+      for (size_t i = 0; i < flows.size (); ++i)
+        {
+          rate[i] = now >= flows[i].start ? flows[i].w * kPacketBytes / (flows[i].rtt0 + queueingDelay) : 0.0;
+          arrival += rate[i];
+        }
+      const double udpRate = (topo.udpMbps > 0.0 && now >= topo.udpStart) ? topo.udpMbps * 1e6 / 8.0 : 0.0;
+      arrival += udpRate;
+
+      // DropTail: arrivals beyond capacity overflow once the buffer is full
+      const bool full = queue >= buffer && arrival > capacity;
+      const double overflow = full ? (arrival - capacity) / arrival : 0.0;
+      const double departure = (queue > 0.0 || arrival > capacity) ? capacity : arrival;
+      queue = std::min (buffer, std::max (0.0, queue + (arrival - departure) * kStep));
+      const double pLoss = 1.0 - (1.0 - overflow) * (1.0 - loss);
+
+      const bool measuring = now >= warmup;
+      for (size_t i = 0; i < flows.size (); ++i)
+        {
+          Flow &f = flows[i];
+          if (now < f.start)
+            {
+              continue;
+            }
+          const double rtt = f.rtt0 + queueingDelay;
+          if (arrival > 0.0)
+            {
+              f.deliveredBytes += departure * rate[i] / arrival * (1.0 - loss) * kStep;
+            }
+          // Expected segment losses; one congestion event per loss, at most once per RTT
+          if (now >= f.recoverUntil)
+            {
+              f.lossCredit += rate[i] / kPacketBytes * pLoss * kStep;
+              if (f.lossCredit >= 1.0)
+                {
+                  OnCongestionEvent (f, variant, now);
+                  f.lossCredit = 0.0;
+                  f.recoverUntil = now + rtt;
+                  continue;
+                }
+            }
+          GrowWindow (f, variant, rtt, now, kStep);
+        }
+      if (arrival > 0.0)
+        {
+          udpDelivered += departure * udpRate / arrival * (1.0 - loss) * kStep;
+        }
+      if (measuring)
+        {
+          queueTime += queueingDelay * kStep;
+          measuredTime += kStep;
+          offered += arrival * kStep;
+          dropped += arrival * pLoss * kStep;
+        }
+    }
+
+  CellResult result;
+  if (measuredTime <= 0.0)
+    {
+      return result;
+    }
+  // Same definition as analysis/aggregate.sh applies to FlowMonitor: every byte received
+  // in the run over the time from the warm-up to the last packet (rxBytes / (tLast - warmup)).
+  const double window = measuredTime;
+  std::vector<double> perFlow;
+  for (const Flow &f : flows)
+    {
+      perFlow.push_back (f.deliveredBytes * 8.0 / window / 1e6);
+      result.tcpTputMbps += perFlow.back ();
+    }
+  result.tputMbps = result.tcpTputMbps;
+  if (topo.udpMbps > 0.0)
+    {
+      perFlow.push_back (udpDelivered * 8.0 / window / 1e6);
+      result.tputMbps += perFlow.back ();
+    }
+  double sum = 0.0;
+  double sumSq = 0.0;
+  for (double x : perFlow)
+    {
+      sum += x;
+      sumSq += x * x;
+    }
+  result.jain = sumSq > 0.0 ? sum * sum / (perFlow.size () * sumSq) : 0.0;
+  result.queueDelayMs = queueTime / measuredTime * 1e3;
+  result.lossRate = offered > 0.0 ? dropped / offered : 0.0;
+  return result;
+}
+
+// Parses an ns-3 QueueSize string ("150p", "1MB", "64KB", "30000B") into packets.
+double
+ParseQueuePackets (const std::string &text)
+{
+  char *end = nullptr;
+  const double value = std::strtod (text.c_str (), &end);
+  const std::string unit (end);
+  if (unit == "p")
+    {
+      return value;
+    }
+  if (unit == "B")
+    {
+      return value / kPacketBytes;
+    }
+  if (unit == "KB" || unit == "kB")
+    {
+      return value * 1000.0 / kPacketBytes;
+    }
+  if (unit == "MB")
+    {
+      return value * 1e6 / kPacketBytes;
+    }
+  std::cerr << "[ERROR] fluid_screen: unsupported queue size " << text << std::endl;
+  std::exit (1);
+}
+
+std::vector<std::string>
+SplitWords (const std::string &text)
+{
+  std::istringstream in (text);
+  std::vector<std::string> words;
+  std::string word;
+  while (in >> word)
+    {
+      words.push_back (word);
+    }
+  return words;
+}
+
+struct Row
+{
+  std::string scenario;
+  std::string tcp;
+  double queuePackets;
+  double loss;
+  double rateMbps;
+  bool supported;
+  bool screenable;
+  CellResult estimate;
+  double elapsedMs;
+  bool predictable = false;
+};
+
+} // namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::vector<std::string> scenarios{"S1", "S2", "S3", "S5"};
+  std::vector<std::string> variants{"TcpNewReno", "TcpCubic", "TcpHybla", "TcpHighSpeed"};
+  std::vector<std::string> queues{"150p"};
+  std::vector<std::string> losses{"0.0"};
+  double rateOverride = 0.0;
+  double simTime = 120.0;
+  double warmup = 20.0;
+  double tolerance = 0.05;
+
+  for (int i = 1; i + 1 < argc; i += 2)
+    {
+      const std::string flag = argv[i];
+      const std::string value = argv[i + 1];
+      if (flag == "--scenarios")
+        {
+          scenarios = SplitWords (value);
+        }
+      else if (flag == "--tcp")
+        {
+          variants = SplitWords (value);
+        }
+      else if (flag == "--queue")
+        {
+          queues = SplitWords (value);
+        }
+      else if (flag == "--loss")
+        {
+          losses = SplitWords (value);
+        }
+      else if (flag == "--rate")
+        {
+          rateOverride = std::atof (value.c_str ());
+        }
+      else if (flag == "--time")
+        {
+          simTime = std::atof (value.c_str ());
+        }
+      else if (flag == "--warmup")
+        {
+          warmup = std::atof (value.c_str ());
+        }
+      else if (flag == "--tolerance")
+        {
+          tolerance = std::atof (value.c_str ());
+        }
+      else
+        {
+          std::cerr << "[ERROR] fluid_screen: unknown option " << flag << std::endl;
+          return 1;
+        }
+    }
+
+  std::vector<Row> rows;
+  for (const std::string &scenario : scenarios)
+    {
+      Topology topo;
+      if (!LookupTopology (scenario, topo))
+        {
+          std::cerr << "[WARN] fluid_screen: no fluid model for " << scenario << ", skipped" << std::endl;
+          continue;
+        }
+      const std::vector<std::string> cellLosses = topo.hasLoss ? losses : std::vector<std::string>{"0.0"};
+      for (const std::string &queue : queues)
+        {
+          for (const std::string &lossText : cellLosses)
+            {
+              const size_t groupBegin = rows.size ();
+              for (const std::string &tcp : variants)
+                {
+                  Row row;
+                  row.scenario = scenario;
+                  row.tcp = tcp;
+                  row.queuePackets = ParseQueuePackets (queue);
+                  row.loss = std::atof (lossText.c_str ());
+                  row.rateMbps = rateOverride > 0.0 ? rateOverride : topo.bottleneckMbps;
+                  const Variant variant = ParseVariant (tcp);
+                  row.supported = variant != Variant::Unsupported;
+                  row.screenable = !topo.shortFlows;
+                  const auto start = std::chrono::steady_clock::now ();
+                  if (row.supported)
+                    {
+                      row.estimate =
+                          SimulateCell (topo, variant, row.queuePackets, row.loss, row.rateMbps, simTime, warmup);
+                    }
+                  row.elapsedMs = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start)
+                                      .count ();
+                  rows.push_back (row);
+                }
+
+              // A group is predictable only if every variant is modelled, the scenario has no
+              // workload the model leaves out, and all variants agree.
+              bool predictable = rows.size () > groupBegin;
+              double minTput = 1e300, maxTput = 0.0, minJain = 1.0, maxJain = 0.0;
+              for (size_t r = groupBegin; r < rows.size (); ++r)
+                {
+                  predictable = predictable && rows[r].supported && rows[r].screenable;
+                  minTput = std::min (minTput, rows[r].estimate.tcpTputMbps);
+                  maxTput = std::max (maxTput, rows[r].estimate.tcpTputMbps);
+                  minJain = std::min (minJain, rows[r].estimate.jain);
+                  maxJain = std::max (maxJain, rows[r].estimate.jain);
+                }
+              predictable = predictable && maxTput > 0.0 && (maxTput - minTput) / maxTput < tolerance
+                            && (maxJain - minJain) < tolerance;
+              for (size_t r = groupBegin; r < rows.size (); ++r)
+                {
+                  rows[r].predictable = predictable;
+                }
+            }
+        }
+    }
+
+  std::cout << "scenario,tcp,queue_p,loss,rate_mbps,tput_mbps,tcp_tput_mbps,jain,queue_delay_ms,loss_rate,"
+               "predictable,elapsed_ms"
+            << std::endl;
+  for (const Row &row : rows)
+    {
+      std::cout << row.scenario << "," << row.tcp << "," << row.queuePackets << "," << row.loss << ","
+                << row.rateMbps << ",";
+      if (row.supported)
+        {
+          std::cout << row.estimate.tputMbps << "," << row.estimate.tcpTputMbps << "," << row.estimate.jain << ","
+                    << row.estimate.queueDelayMs << "," << row.estimate.lossRate;
+        }
+      else
+        {
+          std::cout << ",,,,";
+        }
+      std::cout << "," << (row.predictable ? 1 : 0) << "," << row.elapsedMs << std::endl;
+    }
+  return 0;
+}
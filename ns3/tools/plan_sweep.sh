@@ -0,0 +1,145 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Adaptive sweep over {queue size, loss, bottleneck rate} for one scenario.
+# Starts from a space-filling design, then spends the remaining run budget on points
+# where the throughput/fairness gap between TCP_A and TCP_B changes fastest
+# (see tools/sweep_planner.cc). Writes the sampled points and a fitted response
+# surface to PLAN_OUT.
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+PROJECT_ROOT=$(cd "${SCRIPT_DIR}/.." && pwd)
+NS3_ROOT=${NS3_ROOT:-$HOME/ns-3}
+SCRATCH_PATH="${NS3_ROOT}/scratch"
+PROGRAM_NAME=${PROGRAM_NAME:-tcp_compare}
+SCENARIO=${SCENARIO:-S3}
+TCP_A=${TCP_A:-TcpCubic}
+TCP_B=${TCP_B:-TcpHybla}
+RUN=${RUN:-1}
+SIM_TIME=${SIM_TIME:-60}
+WARMUP=${WARMUP:-20}
+BUDGET=${BUDGET:-60}            # total packet-level simulations (two per sampled point)
+INITIAL_POINTS=${INITIAL_POINTS:-10}
+BATCH=${BATCH:-5}
+QUEUE_RANGE=${QUEUE_RANGE:-"20:600"}   # packets, log scale
+RATE_RANGE=${RATE_RANGE:-"10:100"}     # Mbps, log scale
+if [[ "${SCENARIO}" == "S3" ]]; then
+  LOSS_RANGE=${LOSS_RANGE:-"0.0:0.05"}
+else
+  LOSS_RANGE=${LOSS_RANGE:-"0.0:0.0"}  # only S3 applies --loss
+fi
+GRID=${GRID:-11}
+SEED=${SEED:-1}
+PLAN_ROOT=${PLAN_ROOT:-${NS3_ROOT}/results-plan/${SCENARIO}-${TCP_A}-vs-${TCP_B}}
+PLAN_OUT=${PLAN_OUT:-$(pwd)/plan-${SCENARIO}}
+
+if [[ ! -d "${NS3_ROOT}" ]]; then
+  echo "[ERROR] ns-3 root directory not found: ${NS3_ROOT}" >&2
+  exit 1
+fi
+
+mkdir -p "${PLAN_OUT}" "${PLAN_ROOT}"
+# Absolute paths: the sweep itself runs from inside NS3_ROOT
+PLAN_OUT=$(cd "${PLAN_OUT}" && pwd)
+PLAN_ROOT=$(cd "${PLAN_ROOT}" && pwd)
+
+BUILD_DIR=$(mktemp -d)
+trap 'rm -rf "${BUILD_DIR}"' EXIT
+PLANNER="${BUILD_DIR}/sweep_planner"
+c++ -O2 -std=c++17 -o "${PLANNER}" "${SCRIPT_DIR}/sweep_planner.cc"
+SPACE=(--queue "${QUEUE_RANGE}" --loss "${LOSS_RANGE}" --rate "${RATE_RANGE}")
+
+SAMPLES_CSV="${PLAN_OUT}/samples.csv"
+echo "queue_p,loss,rate_mbps,tput_a,tput_b,jain_a,jain_b" > "${SAMPLES_CSV}"
+
+mkdir -p "${SCRATCH_PATH}"
+cp "${PROJECT_ROOT}/tcp_compare.cc" "${SCRATCH_PATH}/${PROGRAM_NAME}.cc"
+
+# Prints "throughput_mbps jain_index flows" over the TCP data flows of one FlowMonitor
+# XML file, using the same steady-state throughput definition as analysis/aggregate.sh.
+# Data flows go to the fixed sink ports of tcp_compare.cc; the reverse ACK flow of each
+# connection goes back to an ephemeral port (>= 49152) and is left out.
+tcp_metrics() {
+  awk -v warmup="${WARMUP}" '
+    BEGIN { FS="[=\" ]+"; }
+    /<Flow / {
+      flowId=""; rxBytes=""; tFirst=""; tLast=""; protocol="";
+      for (i = 1; i <= NF; ++i) {
+        if ($i == "flowId") flowId = $(i+1);
+        if ($i == "rxBytes") rxBytes = $(i+1);
+        if ($i == "protocol") protocol = $(i+1);
+        if ($i == "destinationPort") dport[flowId] = $(i+1);
+        if ($i == "timeFirstRxPacket") { v = $(i+1); gsub(/^\+|ns$/, "", v); tFirst = v / 1e9; }
+        if ($i == "timeLastRxPacket") { v = $(i+1); gsub(/^\+|ns$/, "", v); tLast = v / 1e9; }
+      }
+      if (protocol != "") { proto[flowId] = protocol; next; }
+      if (flowId != "" && rxBytes != "" && tLast > 0) {
+        duration = tLast - warmup;
+        if (duration <= 0) duration = tLast - tFirst;
+        if (duration > 0 && rxBytes > 0) tput[flowId] = (rxBytes * 8.0) / (duration * 1e6);
+      }
+    }
+    END {
+      sum = 0; sumsq = 0; n = 0;
+      for (f in tput) {
+        if (proto[f] != 6 || dport[f] >= 49152) continue;
+        sum += tput[f]; sumsq += tput[f] * tput[f]; n++;
+      }
+      printf "%f %f %d\n", sum, (n > 0 && sumsq > 0) ? (sum * sum) / (n * sumsq) : 0, n;
+    }
+  ' "$1"
+}
+
+runs_done=0
+point_index=0
+tcp_flows=0
+
+# Simulates every point in a planner CSV for both variants and appends to samples.csv.
+simulate_points() {
+  local queue loss rate point_dir tcp metrics_a metrics_b
+  while IFS=, read -r queue loss rate; do
+    if (( runs_done + 2 > BUDGET )); then
+      break
+    fi
+    point_index=$(( point_index + 1 ))
+    point_dir="${PLAN_ROOT}/p$(printf '%03d' "${point_index}")"
+    for tcp in "${TCP_A}" "${TCP_B}"; do
+      echo "[INFO] Point ${point_index}: queue=${queue}p loss=${loss} rate=${rate}Mbps tcp=${tcp}" >&2
+      ./ns3 run --no-build "scratch/${PROGRAM_NAME} --scenario=${SCENARIO} --tcp=${tcp} --queue=${queue}p --run=${RUN} --loss=${loss} --bottleneckRate=${rate}Mbps --time=${SIM_TIME} --warmup=${WARMUP} --flowMonitor=true --resultDir=${point_dir}" >/dev/null
+    done
+    metrics_a=$(tcp_metrics "${point_dir}/${SCENARIO}/${TCP_A}/run-${RUN}/flowmon.xml")
+    metrics_b=$(tcp_metrics "${point_dir}/${SCENARIO}/${TCP_B}/run-${RUN}/flowmon.xml")
+    read -r tput_a jain_a flows_a <<< "${metrics_a}"
+    read -r tput_b jain_b flows_b <<< "${metrics_b}"
+    tcp_flows=$(( flows_a > flows_b ? flows_a : flows_b ))
+    echo "${queue},${loss},${rate},${tput_a},${tput_b},${jain_a},${jain_b}" >> "${SAMPLES_CSV}"
+    runs_done=$(( runs_done + 2 ))
+  done < <(tail -n +2 "$1")
+}
+
+pushd "${NS3_ROOT}" >/dev/null
+
+./ns3 configure --disable-tests >/dev/null
+./ns3 build >/dev/null
+
+"${PLANNER}" initial --count "${INITIAL_POINTS}" --seed "${SEED}" "${SPACE[@]}" > "${PLAN_OUT}/batch.csv"
+simulate_points "${PLAN_OUT}/batch.csv"
+
+# Jain's index of a single TCP flow is always 1, so only score the fairness gap with >= 2 flows.
+FAIRNESS=$(( tcp_flows >= 2 ? 1 : 0 ))
+while (( runs_done + 2 <= BUDGET )); do
+  "${PLANNER}" refine --samples "${SAMPLES_CSV}" --count "${BATCH}" --fairness "${FAIRNESS}" "${SPACE[@]}" > "${PLAN_OUT}/batch.csv"
+  if [[ $(wc -l < "${PLAN_OUT}/batch.csv") -le 1 ]]; then
+    echo "[INFO] Planner found no further points to refine" >&2
+    break
+  fi
+  simulate_points "${PLAN_OUT}/batch.csv"
+done
+
+popd >/dev/null
+
+"${PLANNER}" fit --samples "${SAMPLES_CSV}" --grid "${GRID}" --model "${PLAN_OUT}/model.csv" "${SPACE[@]}" \
+  > "${PLAN_OUT}/surface.csv"
+rm -f "${PLAN_OUT}/batch.csv"
+
+echo "[INFO] ${runs_done} runs; samples in ${SAMPLES_CSV}, response surface in ${PLAN_OUT}/surface.csv (coefficients and R^2 in model.csv)" >&2
@@ -1,6 +1,11 @@
 #!/usr/bin/env bash
 set -euo pipefail
 
+if (( BASH_VERSINFO[0] < 4 )); then
+  echo "[ERROR] run_tcp_matrix.sh needs bash >= 4 (found ${BASH_VERSION}); on macOS install it with Homebrew" >&2
+  exit 1
+fi
+
 SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
 PROJECT_ROOT=$(cd "${SCRIPT_DIR}/.." && pwd)
 NS3_ROOT=${NS3_ROOT:-$HOME/ns-3}
@@ -13,12 +18,25 @@ QUEUE_SIZE=${QUEUE_SIZE:-150p}
 LOSS_SET=${LOSS_SET:-"0.0 0.01 0.05"}
 BLOCKAGE_SET=${BLOCKAGE_SET:-"0.05 0.2 0.5"}
 FLOW_MONITOR=${FLOW_MONITOR:-true}
+JOBS=${JOBS:-1}
+STATUS_DIR=${STATUS_DIR:-${NS3_ROOT}/results/.status}
+PROGRESS_INTERVAL=${PROGRESS_INTERVAL:-1.0}   # simulated seconds between status updates
+DASHBOARD_INTERVAL=${DASHBOARD_INTERVAL:-10}  # wall seconds between dashboard refreshes
+STALL_TIMEOUT=${STALL_TIMEOUT:-600}           # kill a run whose status is older than this (s)
+SCREEN=${SCREEN:-off}                         # off | order | skip (fluid-model triage, see tools/fluid_screen.cc)
+SCREEN_TOLERANCE=${SCREEN_TOLERANCE:-0.05}    # variants closer than this are "predictable"
+SCREEN_KEEP_RUNS=${SCREEN_KEEP_RUNS:-1}       # SCREEN=skip still simulates this many seeds per cell
 
 if [[ ! -d "${NS3_ROOT}" ]]; then
   echo "[ERROR] ns-3 root directory not found: ${NS3_ROOT}" >&2
   exit 1
 fi
 
+if [[ "${SCREEN}" != "off" && "${SCREEN}" != "order" && "${SCREEN}" != "skip" ]]; then
+  echo "[ERROR] SCREEN must be 'off', 'order' or 'skip', got: ${SCREEN}" >&2
+  exit 1
+fi
+
 mkdir -p "${SCRATCH_PATH}"
 cp "${PROJECT_ROOT}/tcp_compare.cc" "${SCRATCH_PATH}/${PROGRAM_NAME}.cc"
 
@@ -27,6 +45,46 @@ pushd "${NS3_ROOT}" >/dev/null
 ./ns3 configure --disable-tests >/dev/null
 ./ns3 build >/dev/null
 
+mkdir -p "${STATUS_DIR}"
+
+declare -A JOB_OF_PID=()
+SCREEN_BUILD_DIR=""
+
+# Stops every running worker (each is its own process group, see launch_job) so an
+# interrupted runner leaves no orphaned simulations behind.
+cleanup() {
+  local pid
+  for pid in "${!JOB_OF_PID[@]}"; do
+    kill -TERM -- "-${pid}" 2>/dev/null || true
+  done
+  if [[ -n "${SCREEN_BUILD_DIR}" ]]; then
+    rm -rf "${SCREEN_BUILD_DIR}"
+  fi
+}
+trap cleanup EXIT
+trap 'echo "[ERROR] Interrupted; stopping ${#JOB_OF_PID[@]} running simulation(s)" >&2; exit 130' INT TERM
+
+# Fluid screening: cells whose variants the model expects to behave alike are either
+# moved to the end of the queue (order) or reduced to SCREEN_KEEP_RUNS seeds (skip).
+declare -A PREDICTABLE=()
+if [[ "${SCREEN}" != "off" ]]; then
+  SCREEN_CSV="${NS3_ROOT}/results/screen.csv"
+  SCREEN_BUILD_DIR=$(mktemp -d)
+  c++ -O2 -std=c++17 -o "${SCREEN_BUILD_DIR}/fluid_screen" "${SCRIPT_DIR}/fluid_screen.cc"
+  "${SCREEN_BUILD_DIR}/fluid_screen" --scenarios "${SCENARIOS}" --tcp "${TCP_VARIANTS}" --queue "${QUEUE_SIZE}" \
+    --loss "${LOSS_SET}" --tolerance "${SCREEN_TOLERANCE}" > "${SCREEN_CSV}"
+  while IFS=, read -r scenario tcp _ loss _ _ _ _ _ _ predictable _; do
+    if [[ "${predictable}" == "1" ]]; then
+      PREDICTABLE["${scenario} ${tcp} $(printf '%g' "${loss}")"]=1
+    fi
+  done < <(tail -n +2 "${SCREEN_CSV}")
+  echo "[INFO] Fluid screening: ${#PREDICTABLE[@]} predictable cell(s); estimates in ${SCREEN_CSV}" >&2
+fi
+
+# Build the job list first: "scenario tcp loss blockage run" per entry
+JOB_LIST=()
+DEFERRED_JOBS=()
+SCREENED_OUT=0
 for scenario in ${SCENARIOS}; do
   for tcp in ${TCP_VARIANTS}; do
     case "${scenario}" in
@@ -46,14 +104,137 @@ for scenario in ${SCENARIOS}; do
     for loss in ${loss_values}; do
       for blockage in ${blockage_values}; do
         for run in $(seq 1 ${RUNS}); do
-          echo "[INFO] Running scenario=${scenario} tcp=${tcp} loss=${loss} blockage=${blockage} run=${run}" >&2
-          ./ns3 run "scratch/${PROGRAM_NAME} --scenario=${scenario} --tcp=${tcp} --queue=${QUEUE_SIZE} --run=${run} --loss=${loss} --blockage=${blockage} --flowMonitor=${FLOW_MONITOR}" >/dev/null
+          if [[ -n "${PREDICTABLE["${scenario} ${tcp} $(printf '%g' "${loss}")"]:-}" ]]; then
+            if [[ "${SCREEN}" == "skip" && ${run} -gt ${SCREEN_KEEP_RUNS} ]]; then
+              SCREENED_OUT=$(( SCREENED_OUT + 1 ))
+              continue
+            elif [[ "${SCREEN}" == "order" ]]; then
+              DEFERRED_JOBS+=("${scenario} ${tcp} ${loss} ${blockage} ${run}")
+              continue
+            fi
+          fi
+          JOB_LIST+=("${scenario} ${tcp} ${loss} ${blockage} ${run}")
         done
       done
     done
   done
 done
+JOB_LIST+=(${DEFERRED_JOBS[@]+"${DEFERRED_JOBS[@]}"})
+if [[ ${SCREENED_OUT} -gt 0 || ${#DEFERRED_JOBS[@]} -gt 0 ]]; then
+  echo "[INFO] Screening skipped ${SCREENED_OUT} run(s) and deferred ${#DEFERRED_JOBS[@]} run(s)" >&2
+fi
+
+declare -A LAST_SEEN=()
+FAILED=0
+
+job_id() {
+  echo "$1-$2-l$3-b$4-r$5"
+}
+
+# Result root of a job. The swept parameter gets its own tree (results/loss-<x> for S3,
+# results/blockage-<x> for S4) so runs for different values never overwrite each other,
+# whatever order the jobs execute in.
+job_root() {
+  local scenario tcp loss blockage run
+  read -r scenario tcp loss blockage run <<< "$1"
+  case "${scenario}" in
+    S3) echo "results/loss-${loss}" ;;
+    S4) echo "results/blockage-${blockage}" ;;
+    *) echo "results" ;;
+  esac
+}
+
+# Last-modified time of a file in epoch seconds (GNU and BSD date both support -r)
+mtime() {
+  date -r "$1" +%s
+}
+
+launch_job() {
+  local scenario tcp loss blockage run id
+  read -r scenario tcp loss blockage run <<< "$1"
+  id=$(job_id "${scenario}" "${tcp}" "${loss}" "${blockage}" "${run}")
+  rm -f "${STATUS_DIR}/${id}.status"
+  echo "[INFO] Running scenario=${scenario} tcp=${tcp} loss=${loss} blockage=${blockage} run=${run}" >&2
+  # Job control only while forking: the worker gets its own process group (so a stalled
+  # run can be killed as a whole) while the runner itself keeps receiving Ctrl-C.
+  set -m
+  ./ns3 run --no-build "scratch/${PROGRAM_NAME} --scenario=${scenario} --tcp=${tcp} --queue=${QUEUE_SIZE} --run=${run} --loss=${loss} --blockage=${blockage} --flowMonitor=${FLOW_MONITOR} --resultDir=${NS3_ROOT}/$(job_root "$1") --statusFile=${STATUS_DIR}/${id}.status --progressInterval=${PROGRESS_INTERVAL}" \
+    >"${STATUS_DIR}/${id}.log" 2>&1 &
+  set +m
+  JOB_OF_PID[$!]=${id}
+  LAST_SEEN[$!]=$(date +%s)
+}
+
+release_job() {
+  unset "JOB_OF_PID[$1]" "LAST_SEEN[$1]"
+}
+
+print_dashboard() {
+  local pid id status
+  {
+    printf '[INFO] %s  running=%d pending=%d failed=%d\n' "$(date +%H:%M:%S)" "${#JOB_OF_PID[@]}" $(( ${#JOB_LIST[@]} - NEXT_JOB )) "${FAILED}"
+    printf '  %-36s %6s %9s %11s %8s %9s  %s\n' "run" "pct" "sim(s)" "events/s" "eta(s)" "rss(MB)" "flow Mbps"
+    for pid in "${!JOB_OF_PID[@]}"; do
+      id=${JOB_OF_PID[${pid}]}
+      status="${STATUS_DIR}/${id}.status"
+      if [[ -f "${status}" ]]; then
+        awk -v id="${id}" '{
+          for (i = 1; i <= NF; ++i) { split($i, kv, "="); v[kv[1]] = kv[2]; }
+          printf "  %-36s %5.1f%% %9.1f %11.0f %8.0f %9.1f  %s\n", id, v["pct"], v["sim"], v["eps"], v["eta"], v["rss_kb"] / 1024, v["flows"];
+        }' "${status}"
+      else
+        printf '  %-36s %6s\n' "${id}" "start"
+      fi
+    done
+  } >&2
+}
+
+NEXT_JOB=0
+last_dashboard=0
+while [[ ${NEXT_JOB} -lt ${#JOB_LIST[@]} || ${#JOB_OF_PID[@]} -gt 0 ]]; do
+  while [[ ${NEXT_JOB} -lt ${#JOB_LIST[@]} && ${#JOB_OF_PID[@]} -lt ${JOBS} ]]; do
+    launch_job "${JOB_LIST[${NEXT_JOB}]}"
+    NEXT_JOB=$(( NEXT_JOB + 1 ))
+  done
+
+  now=$(date +%s)
+  for pid in "${!JOB_OF_PID[@]}"; do
+    id=${JOB_OF_PID[${pid}]}
+    if ! kill -0 "${pid}" 2>/dev/null; then
+      if wait "${pid}"; then
+        :
+      else
+        echo "[ERROR] Run ${id} failed; see ${STATUS_DIR}/${id}.log" >&2
+        FAILED=$(( FAILED + 1 ))
+      fi
+      release_job "${pid}"
+      continue
+    fi
+    status="${STATUS_DIR}/${id}.status"
+    if [[ -f "${status}" ]]; then
+      LAST_SEEN[${pid}]=$(mtime "${status}")
+    fi
+    if (( now - LAST_SEEN[${pid}] > STALL_TIMEOUT )); then
+      echo "[ERROR] Run ${id} stalled (no progress for ${STALL_TIMEOUT}s); killing" >&2
+      kill -TERM -- "-${pid}" 2>/dev/null || true
+      wait "${pid}" 2>/dev/null || true
+      FAILED=$(( FAILED + 1 ))
+      release_job "${pid}"
+    fi
+  done
+
+  if (( now - last_dashboard >= DASHBOARD_INTERVAL )) && [[ ${#JOB_OF_PID[@]} -gt 0 ]]; then
+    print_dashboard
+    last_dashboard=${now}
+  fi
+  sleep 1
+done
 
 popd >/dev/null
 
+if [[ ${FAILED} -gt 0 ]]; then
+  echo "[ERROR] ${FAILED} run(s) failed or stalled; logs in ${STATUS_DIR}" >&2
+  exit 1
+fi
+
 echo "[INFO] Simulation matrix complete. Results stored under ${NS3_ROOT}/results" >&2
@@ -0,0 +1,620 @@
+// Adaptive sweep planner used by tools/plan_sweep.sh.
+//
+// The sweep space is {bottleneck queue (packets), loss rate, bottleneck rate (Mbps)}.
+// Queue and rate are explored on a log scale, loss on a linear scale; a dimension
+// whose lower and upper bounds are equal is held fixed.
+//
+//   sweep_planner initial --count K [--seed S] <space>
+//       Space-filling start design (maximin Latin hypercube), one point per line.
+//   sweep_planner refine --samples samples.csv --count B [--fairness 0|1] <space>
+//       Next B points, placed between already simulated points where the gap
+//       between the two TCP variants changes fastest or flips sign. With
+//       --fairness 0 only the throughput gap is scored (single-flow scenarios,
+//       where the Jain index is always 1).
+//   sweep_planner fit --samples samples.csv [--grid G] [--model model.csv] <space>
+//       Quadratic response surface of the throughput and fairness gaps, evaluated
+//       on a G^d grid (stdout) with coefficients and R^2 written to --model.
+//
+// <space> is "--queue lo:hi --loss lo:hi --rate lo:hi". samples.csv is written by
+// plan_sweep.sh with the header
+//   queue_p,loss,rate_mbps,tput_a,tput_b,jain_a,jain_b
+//
+// Build: c++ -O2 -std=c++17 -o sweep_planner sweep_planner.cc
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int kDims = 3;
+const char *const kDimNames[kDims] = {"queue_p", "loss", "rate_mbps"};
+
+struct Dimension
+{
+  double lo = 0.0;
+  double hi = 0.0;
+  bool logScale = false;
+
+  bool Fixed () const { return lo == hi; }
+
+  double ToUnit (double value) const
+  {
+    if (Fixed ())
+      {
+        return 0.0;
+      }
+    if (logScale)
+      {
+        return (std::log (value) - std::log (lo)) / (std::log (hi) - std::log (lo));
+      }
+    return (value - lo) / (hi - lo);
+  }
+
+  double FromUnit (double u) const
+  {
+    if (Fixed ())
+      {
+        return lo;
+      }
+    if (logScale)
+      {
+        return std::exp (std::log (lo) + u * (std::log (hi) - std::log (lo)));
+      }
+    return lo + u * (hi - lo);
+  }
+};
+
+struct Space
+{
+  Dimension dims[kDims];
+
+  std::vector<int> Active () const
+  {
+    std::vector<int> active;
+    for (int d = 0; d < kDims; ++d)
+      {
+        if (!dims[d].Fixed ())
+          {
+            active.push_back (d);
+          }
+      }
+    return active;
+  }
+};
+
+struct Sample
+{
+  double x[kDims];   // natural units
+  double u[kDims];   // unit cube
+  double tputGap;    // (tput_a - tput_b) / max(tput_a, tput_b)
+  double jainGap;    // jain_a - jain_b
+};
+
+struct Options
+{
+  std::string command;
+  Space space;
+  std::string samplesPath;
+  std::string modelPath;
+  int count = 0;
+  int grid = 11;
+  uint32_t seed = 1;
+  bool fairness = true;
+};
+
+[[noreturn]] void
+Fail (const std::string &message)
+{
+  std::cerr << "[ERROR] sweep_planner: " << message << std::endl;
+  std::exit (1);
+}
+
+Dimension
+ParseRange (const std::string &text, bool logScale)
+{
+  Dimension dim;
+  const auto colon = text.find (':');
+  if (colon == std::string::npos)
+    {
+      Fail ("expected lo:hi, got " + text);
+    }
+  dim.lo = std::atof (text.substr (0, colon).c_str ());
+  dim.hi = std::atof (text.substr (colon + 1).c_str ());
+  dim.logScale = logScale;
+  if (dim.hi < dim.lo || (logScale && dim.lo <= 0.0))
+    {
+      Fail ("invalid range " + text);
+    }
+  return dim;
+}
+
+Options
+ParseArgs (int argc, char *argv[])
+{
+  if (argc < 2)
+    {
+      Fail ("usage: sweep_planner initial|refine|fit [options]");
+    }
+  Options opts;
+  opts.command = argv[1];
+  opts.space.dims[0] = ParseRange ("150:150", true);
+  opts.space.dims[1] = ParseRange ("0:0", false);
+  opts.space.dims[2] = ParseRange ("20:20", true);
+  for (int i = 2; i < argc; ++i)
+    {
+      const std::string flag = argv[i];
+      if (i + 1 >= argc)
+        {
+          Fail ("missing value for " + flag);
+        }
+      const std::string value = argv[++i];
+      if (flag == "--queue")
+        {
+          opts.space.dims[0] = ParseRange (value, true);
+        }
+      else if (flag == "--loss")
+        {
+          opts.space.dims[1] = ParseRange (value, false);
+        }
+      else if (flag == "--rate")
+        {
+          opts.space.dims[2] = ParseRange (value, true);
+        }
+      else if (flag == "--samples")
+        {
+          opts.samplesPath = value;
+        }
+      else if (flag == "--model")
+        {
+          opts.modelPath = value;
+        }
+      else if (flag == "--count")
+        {
+          opts.count = std::atoi (value.c_str ());
+        }
+      else if (flag == "--grid")
+        {
+          opts.grid = std::max (2, std::atoi (value.c_str ()));
+        }
+      else if (flag == "--fairness")
+        {
+          opts.fairness = std::atoi (value.c_str ()) != 0;
+        }
+      else if (flag == "--seed")
+        {
+          opts.seed = static_cast<uint32_t> (std::strtoul (value.c_str (), nullptr, 10));
+        }
+      else
+        {
+          Fail ("unknown option " + flag);
+        }
+    }
+  return opts;
+}
+
+std::vector<Sample>
+ReadSamples (const std::string &path, const Space &space)
+{
+  std::ifstream in (path);
+  if (!in)
+    {
+      Fail ("cannot open samples file " + path);
+    }
+  std::vector<Sample> samples;
+  std::string line;
+  std::getline (in, line); // header
+  while (std::getline (in, line))
+    {
+      if (line.empty ())
+        {
+          continue;
+        }
+      std::replace (line.begin (), line.end (), ',', ' ');
+      std::istringstream fields (line);
+      Sample s;
+      double tputA, tputB, jainA, jainB;
+      if (!(fields >> s.x[0] >> s.x[1] >> s.x[2] >> tputA >> tputB >> jainA >> jainB))
+        {
+          Fail ("malformed sample: " + line);
+        }
+      for (int d = 0; d < kDims; ++d)
+        {
+          s.u[d] = space.dims[d].ToUnit (s.x[d]);
+        }
+      const double tputMax = std::max (tputA, tputB);
+      s.tputGap = tputMax > 0.0 ? (tputA - tputB) / tputMax : 0.0;
+      s.jainGap = jainA - jainB;
+      samples.push_back (s);
+    }
+  return samples;
+}
+
+double
+UnitDistance (const double *a, const double *b, const std::vector<int> &active)
+{
+  double sum = 0.0;
+  for (int d : active)
+    {
+      sum += (a[d] - b[d]) * (a[d] - b[d]);
+    }
+  return std::sqrt (sum);
+}
+
+void
+PrintPoint (const Space &space, const double *u)
+{
+  std::cout << std::lround (space.dims[0].FromUnit (u[0])) << "," << space.dims[1].FromUnit (u[1]) << ","
+            << space.dims[2].FromUnit (u[2]) << std::endl;
+}
+
+// Maximin Latin hypercube: keep the best of a few random LHS designs.
+int
+RunInitial (const Options &opts)
+{
+  const std::vector<int> active = opts.space.Active ();
+  const int n = std::max (1, opts.count);
+  std::mt19937 rng (opts.seed);
+  std::uniform_real_distribution<double> jitter (0.0, 1.0);
+
+  std::vector<std::vector<double>> best;
+  double bestMinDist = -1.0;
+  for (int attempt = 0; attempt < 200; ++attempt)
+    {
+      std::vector<std::vector<double>> design (n, std::vector<double> (kDims, 0.0));
+      for (int d : active)
+        {
+          std::vector<int> strata (n);
+          for (int i = 0; i < n; ++i)
+            {
+              strata[i] = i;
+            }
+          std::shuffle (strata.begin (), strata.end (), rng);
+          for (int i = 0; i < n; ++i)
+            {
+              design[i][d] = (strata[i] + jitter (rng)) / n;
+            }
+        }
+      double minDist = std::numeric_limits<double>::max ();
+      for (int i = 0; i < n; ++i)
+        {
+          for (int j = i + 1; j < n; ++j)
+            {
+              minDist = std::min (minDist, UnitDistance (design[i].data (), design[j].data (), active));
+            }
+        }
+      if (minDist > bestMinDist)
+        {
+          bestMinDist = minDist;
+          best = design;
+        }
+    }
+
+  std::cout << "queue_p,loss,rate_mbps" << std::endl;
+  for (const auto &point : best)
+    {
+      PrintPoint (opts.space, point.data ());
+    }
+  return 0;
+}
+
+// Scores the segment between each sample and its nearest neighbours by how much the
+// variant gaps change along it (a sign flip marks a crossover such as the loss rate
+// where one variant falls behind the other) and proposes the segment midpoints.
+int
+RunRefine (const Options &opts)
+{
+  const std::vector<int> active = opts.space.Active ();
+  const std::vector<Sample> samples = ReadSamples (opts.samplesPath, opts.space);
+  const size_t kNeighbours = std::min<size_t> (2 * active.size () + 2, samples.size () ? samples.size () - 1 : 0);
+  const double minSpacing = 0.02;
+
+  struct Candidate
+  {
+    double score;
+    double u[kDims];
+  };
+  std::vector<Candidate> candidates;
+
+  for (size_t i = 0; i < samples.size (); ++i)
+    {
+      std::vector<std::pair<double, size_t>> byDistance;
+      for (size_t j = 0; j < samples.size (); ++j)
+        {
+          if (j != i)
+            {
+              byDistance.emplace_back (UnitDistance (samples[i].u, samples[j].u, active), j);
+            }
+        }
+      std::sort (byDistance.begin (), byDistance.end ());
+      for (size_t k = 0; k < kNeighbours && k < byDistance.size (); ++k)
+        {
+          const size_t j = byDistance[k].second;
+          const double length = byDistance[k].first;
+          if (j < i || length < 2.0 * minSpacing)
+            {
+              continue; // each segment once; too short to split
+            }
+          const Sample &a = samples[i];
+          const Sample &b = samples[j];
+          double change = std::fabs (a.tputGap - b.tputGap);
+          if (opts.fairness)
+            {
+              change += std::fabs (a.jainGap - b.jainGap);
+            }
+          if ((a.tputGap > 0.0) != (b.tputGap > 0.0))
+            {
+              change *= 2.0;
+            }
+          Candidate c;
+          c.score = change * std::sqrt (length);
+          for (int d = 0; d < kDims; ++d)
+            {
+              c.u[d] = 0.5 * (a.u[d] + b.u[d]);
+            }
+          candidates.push_back (c);
+        }
+    }
+
+  std::sort (candidates.begin (), candidates.end (),
+             [] (const Candidate &a, const Candidate &b) { return a.score > b.score; });
+
+  std::vector<const double *> taken;
+  for (const Sample &s : samples)
+    {
+      taken.push_back (s.u);
+    }
+
+  std::cout << "queue_p,loss,rate_mbps" << std::endl;
+  int emitted = 0;
+  for (const Candidate &c : candidates)
+    {
+      if (emitted >= opts.count)
+        {
+          break;
+        }
+      bool tooClose = false;
+      for (const double *u : taken)
+        {
+          if (UnitDistance (c.u, u, active) < minSpacing)
+            {
+              tooClose = true;
+              break;
+            }
+        }
+      if (tooClose)
+        {
+          continue;
+        }
+      taken.push_back (c.u);
+      PrintPoint (opts.space, c.u);
+      ++emitted;
+    }
+  return 0;
+}
+
+// Quadratic basis over the active dimensions: 1, u_d, u_d * u_e (d <= e).
+std::vector<double>
+Basis (const double *u, const std::vector<int> &active, bool quadratic)
+{
+  std::vector<double> terms{1.0};
+  for (int d : active)
+    {
+      terms.push_back (u[d]);
+    }
+  if (quadratic)
+    {
+      for (size_t i = 0; i < active.size (); ++i)
+        {
+          for (size_t j = i; j < active.size (); ++j)
+            {
+              terms.push_back (u[active[i]] * u[active[j]]);
+            }
+        }
+    }
+  return terms;
+}
+
+std::vector<std::string>
+BasisNames (const std::vector<int> &active, bool quadratic)
+{
+  std::vector<std::string> names{"1"};
+  for (int d : active)
+    {
+      names.push_back (kDimNames[d]);
+    }
+  if (quadratic)
+    {
+      for (size_t i = 0; i < active.size (); ++i)
+        {
+          for (size_t j = i; j < active.size (); ++j)
+            {
+              names.push_back (std::string (kDimNames[active[i]]) + "*" + kDimNames[active[j]]);
+            }
+        }
+    }
+  return names;
+}
+
+// Ridge-regularised least squares via the normal equations (Gauss-Jordan with pivoting).
+std::vector<double>
+LeastSquares (const std::vector<std::vector<double>> &rows, const std::vector<double> &y)
+{
+  const size_t p = rows.front ().size ();
+  std::vector<std::vector<double>> a (p, std::vector<double> (p + 1, 0.0));
+  for (size_t r = 0; r < rows.size (); ++r)
+    {
+      for (size_t i = 0; i < p; ++i)
+        {
+          for (size_t j = 0; j < p; ++j)
+            {
+              a[i][j] += rows[r][i] * rows[r][j];
+            }
+          a[i][p] += rows[r][i] * y[r];
+        }
+    }
+  for (size_t i = 1; i < p; ++i)
+    {
+      a[i][i] += 1e-6; // keep the system solvable with clustered samples
+    }
+  for (size_t col = 0; col < p; ++col)
+    {
+      size_t pivot = col;
+      for (size_t r = col + 1; r < p; ++r)
+        {
+          if (std::fabs (a[r][col]) > std::fabs (a[pivot][col]))
+            {
+              pivot = r;
+            }
+        }
+      std::swap (a[col], a[pivot]);
+      if (std::fabs (a[col][col]) < 1e-12)
+        {
+          continue;
+        }
+      for (size_t r = 0; r < p; ++r)
+        {
+          if (r == col)
+            {
+              continue;
+            }
+          const double factor = a[r][col] / a[col][col];
+          for (size_t c = col; c <= p; ++c)
+            {
+              a[r][c] -= factor * a[col][c];
+            }
+        }
+    }
+  std::vector<double> beta (p, 0.0);
+  for (size_t i = 0; i < p; ++i)
+    {
+      beta[i] = std::fabs (a[i][i]) < 1e-12 ? 0.0 : a[i][p] / a[i][i];
+    }
+  return beta;
+}
+
+double
+Dot (const std::vector<double> &a, const std::vector<double> &b)
+{
+  double sum = 0.0;
+  for (size_t i = 0; i < a.size (); ++i)
+    {
+      sum += a[i] * b[i];
+    }
+  return sum;
+}
+
+double
+RSquared (const std::vector<std::vector<double>> &rows, const std::vector<double> &y,
+          const std::vector<double> &beta)
+{
+  double mean = 0.0;
+  for (double v : y)
+    {
+      mean += v;
+    }
+  mean /= y.size ();
+  double ssRes = 0.0;
+  double ssTot = 0.0;
+  for (size_t r = 0; r < rows.size (); ++r)
+    {
+      const double residual = y[r] - Dot (rows[r], beta);
+      ssRes += residual * residual;
+      ssTot += (y[r] - mean) * (y[r] - mean);
+    }
+  return ssTot > 0.0 ? 1.0 - ssRes / ssTot : 1.0;
+}
+
+int
+RunFit (const Options &opts)
+{
+  const std::vector<int> active = opts.space.Active ();
+  const std::vector<Sample> samples = ReadSamples (opts.samplesPath, opts.space);
+  const size_t quadraticTerms = 1 + active.size () + active.size () * (active.size () + 1) / 2;
+  const bool quadratic = samples.size () >= quadraticTerms + 2;
+  if (samples.size () < active.size () + 1)
+    {
+      Fail ("not enough samples to fit a response surface");
+    }
+
+  std::vector<std::vector<double>> rows;
+  std::vector<double> tput;
+  std::vector<double> jain;
+  for (const Sample &s : samples)
+    {
+      rows.push_back (Basis (s.u, active, quadratic));
+      tput.push_back (s.tputGap);
+      jain.push_back (s.jainGap);
+    }
+  const std::vector<double> betaTput = LeastSquares (rows, tput);
+  const std::vector<double> betaJain = LeastSquares (rows, jain);
+
+  if (!opts.modelPath.empty ())
+    {
+      std::ofstream model (opts.modelPath);
+      const std::vector<std::string> names = BasisNames (active, quadratic);
+      model << "term,tput_gap,jain_gap" << std::endl;
+      for (size_t i = 0; i < names.size (); ++i)
+        {
+          model << names[i] << "," << betaTput[i] << "," << betaJain[i] << std::endl;
+        }
+      model << "r2," << RSquared (rows, tput, betaTput) << "," << RSquared (rows, jain, betaJain) << std::endl;
+    }
+
+  // Walk the G^d grid over the active dimensions (coefficients are in unit-cube coordinates).
+  std::cout << "queue_p,loss,rate_mbps,tput_gap,jain_gap" << std::endl;
+  std::vector<int> index (active.size (), 0);
+  while (true)
+    {
+      double u[kDims] = {0.0, 0.0, 0.0};
+      for (size_t i = 0; i < active.size (); ++i)
+        {
+          u[active[i]] = static_cast<double> (index[i]) / (opts.grid - 1);
+        }
+      const std::vector<double> terms = Basis (u, active, quadratic);
+      std::cout << opts.space.dims[0].FromUnit (u[0]) << "," << opts.space.dims[1].FromUnit (u[1]) << ","
+                << opts.space.dims[2].FromUnit (u[2]) << "," << Dot (terms, betaTput) << ","
+                << Dot (terms, betaJain) << std::endl;
+
+      size_t carry = 0;
+      while (carry < index.size () && ++index[carry] == opts.grid)
+        {
+          index[carry++] = 0;
+        }
+      if (carry == index.size ())
+        {
+          break;
+        }
+    }
+  return 0;
+}
+
+} // namespace
+
+int
+main (int argc, char *argv[])
+{
+  const Options opts = ParseArgs (argc, argv);
+  if (opts.command == "initial")
+    {
+      return RunInitial (opts);
+    }
+  if (opts.command == "refine")
+    {
+      return RunRefine (opts);
+    }
+  if (opts.command == "fit")
+    {
+      return RunFit (opts);
+    }
+  Fail ("unknown command " + opts.command);
+}